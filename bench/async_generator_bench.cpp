@@ -0,0 +1,111 @@
+#include "bench.hpp"
+
+#include <iol/async_generator.hpp>
+#include <iol/awaitable.hpp>
+#include <iol/sync_wait.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+constexpr int items = 1'000'000;
+
+async_generator<int> produce(int n)
+{
+  for (int i = 0; i < n; ++i)
+    co_yield i;
+}
+
+awaitable<long> consume(async_generator<int> gen)
+{
+  long sum = 0;
+  for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it)
+    sum += *it;
+  co_return sum;
+}
+
+// the usual alternative, a producer thread handing items over through a locked queue
+class channel
+{
+
+public:
+
+  void push(int item)
+  {
+    {
+      std::scoped_lock lock{mutex_};
+      items_.push_back(item);
+    }
+    cv_.notify_one();
+  }
+
+  void close()
+  {
+    {
+      std::scoped_lock lock{mutex_};
+      closed_ = true;
+    }
+    cv_.notify_one();
+  }
+
+  std::optional<int> pop()
+  {
+    std::unique_lock lock{mutex_};
+    cv_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty())
+      return std::nullopt;
+    int const item = items_.front();
+    items_.pop_front();
+    return item;
+  }
+
+private:
+
+  std::mutex              mutex_;
+  std::condition_variable cv_;
+  std::deque<int>         items_;
+  bool                    closed_ = false;
+};
+
+}  // namespace local
+
+}  // namespace
+
+IOL_BENCH(async_generator_throughput)
+{
+  auto const generated = iol_bench::time(
+      []
+      {
+        auto const sum = iol::sync_wait(local::consume(local::produce(local::items)));
+        iol_bench::do_not_optimize(sum);
+      });
+  iol_bench::report("async_generator", local::items, generated);
+
+  auto const channeled = iol_bench::time(
+      []
+      {
+        local::channel channel;
+        std::thread    producer{[&]
+                             {
+                               for (int i = 0; i < local::items; ++i)
+                                 channel.push(i);
+                               channel.close();
+                             }};
+        long sum = 0;
+        while (auto item = channel.pop())
+          sum += *item;
+        producer.join();
+        iol_bench::do_not_optimize(sum);
+      });
+  iol_bench::report("locked queue channel, producer thread", local::items, channeled);
+}
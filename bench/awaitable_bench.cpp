@@ -0,0 +1,76 @@
+#include "bench.hpp"
+
+#include <iol/awaitable.hpp>
+#include <iol/sync_wait.hpp>
+
+#include <cstddef>
+#include <memory>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+constexpr int awaits = 1'000'000;
+
+awaitable<int> cached_leaf(int i)
+{
+  co_return i;
+}
+
+awaitable<int> heap_leaf(std::allocator_arg_t, std::allocator<std::byte>, int i)
+{
+  co_return i;
+}
+
+struct cached {
+  static awaitable<int> leaf(int i) { return cached_leaf(i); }
+};
+
+struct heap {
+  static awaitable<int> leaf(int i)
+  {
+    return heap_leaf(std::allocator_arg, std::allocator<std::byte>{}, i);
+  }
+};
+
+template <typename Frames>
+awaitable<long> chain(int n)
+{
+  long sum = 0;
+  for (int i = 0; i < n; ++i)
+    sum += co_await Frames::leaf(i);
+  co_return sum;
+}
+
+/*
+ * Each co_await starts a new child coroutine, the time is mostly its frame allocation and
+ * the resumption of the parent.
+ * */
+template <typename Frames>
+void co_await_chain(char const* label)
+{
+  // warms up this thread's cache
+  iol_bench::do_not_optimize(sync_wait(chain<Frames>(1000)));
+
+  auto const before = iol_bench::allocation_count();
+  auto const elapsed =
+      iol_bench::time([] { iol_bench::do_not_optimize(sync_wait(chain<Frames>(awaits))); });
+  auto const allocations = iol_bench::allocation_count() - before;
+
+  iol_bench::report(label, awaits, elapsed);
+  iol_bench::report(label, "allocations/op", double(allocations) / awaits);
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_BENCH(awaitable_co_await_chain)
+{
+  local::co_await_chain<local::cached>("thread_caching_allocator frames");
+  local::co_await_chain<local::heap>("std::allocator frames, allocator_arg");
+}
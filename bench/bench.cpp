@@ -0,0 +1,83 @@
+#include "bench.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace
+{
+
+namespace local
+{
+
+std::atomic_size_t allocations{0};
+
+}  // namespace local
+
+}  // namespace
+
+// counts every allocation, the benchmarks report allocations per operation
+void* operator new(std::size_t size)
+{
+  local::allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+  local::allocations.fetch_add(1, std::memory_order_relaxed);
+  auto const alignment = static_cast<std::size_t>(align);
+  if (auto* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    return p;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace iol_bench
+{
+
+std::size_t allocation_count() noexcept
+{
+  return local::allocations.load(std::memory_order_relaxed);
+}
+
+std::vector<benchmark>& registry()
+{
+  static std::vector<benchmark> benchmarks;
+  return benchmarks;
+}
+
+void report(char const* label, std::size_t ops, clock_type::duration elapsed)
+{
+  auto const ns = std::chrono::duration<double, std::nano>{elapsed}.count();
+  std::printf("  %-48s %12.1f ns/op %14.0f ops/s\n", label, ns / ops, ops / ns * 1e9);
+}
+
+void report(char const* label, char const* counter, double value)
+{
+  std::printf("  %-48s %12.2f %s\n", label, value, counter);
+}
+
+void run(char const* filter)
+{
+  for (auto& bench : registry()) {
+    if (filter && !std::strstr(bench.name, filter))
+      continue;
+    std::printf("%s\n", bench.name);
+    std::fflush(stdout);
+    bench.fn();
+  }
+}
+
+}  // namespace iol_bench
@@ -0,0 +1,60 @@
+#ifndef IOL_BENCH_BENCH_HPP
+#define IOL_BENCH_BENCH_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace iol_bench
+{
+
+using clock_type = std::chrono::steady_clock;
+
+struct benchmark {
+  char const* name;
+  void (*fn)();
+};
+
+std::vector<benchmark>& registry();
+
+struct registrar {
+  registrar(char const* name, void (*fn)()) { registry().push_back({name, fn}); }
+};
+
+template <typename Function>
+clock_type::duration time(Function&& function)
+{
+  auto const start = clock_type::now();
+  function();
+  return clock_type::now() - start;
+}
+
+// prints one result line, the time per operation over ops operations
+void report(char const* label, std::size_t ops, clock_type::duration elapsed);
+
+// prints one result line for a counter that isn't a time
+void report(char const* label, char const* counter, double value);
+
+// global operator new calls so far, on any thread
+std::size_t allocation_count() noexcept;
+
+// keeps the compiler from optimizing away the computation of value
+template <typename T>
+void do_not_optimize(T const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/*
+ * Runs every registered benchmark whose name contains filter, all of them if filter is null.
+ * */
+void run(char const* filter);
+
+}  // namespace iol_bench
+
+#define IOL_BENCH(NAME)                                              \
+  static void NAME();                                                \
+  static ::iol_bench::registrar const NAME##_registrar{#NAME, NAME}; \
+  static void NAME()
+
+#endif  // IOL_BENCH_BENCH_HPP
@@ -0,0 +1,6 @@
+#include "bench.hpp"
+
+int main(int argc, char* argv[])
+{
+  iol_bench::run(argc > 1 ? argv[1] : nullptr);
+}
@@ -0,0 +1,156 @@
+#include "bench.hpp"
+
+#include <iol/async_mutex.hpp>
+#include <iol/awaitable.hpp>
+#include <iol/detail/fast_mutex.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+#include <iol/when_all.hpp>
+
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+constexpr std::size_t locks = 1'000'000;
+
+awaitable<void> lock_loop(
+    static_thread_pool& pool, async_mutex& mutex, long& counter, std::size_t n)
+{
+  co_await pool.schedule();
+  for (std::size_t i = 0; i < n; ++i) {
+    auto lock = co_await mutex.scoped_lock_on(pool);
+    ++counter;
+  }
+}
+
+awaitable<void> all(std::vector<awaitable<void>> tasks)
+{
+  co_await when_all(std::move(tasks));
+}
+
+/*
+ * tasks coroutines on a 4 thread pool share one counter, a waiting task suspends and is
+ * posted back to the pool when the lock gets handed to it.
+ * */
+void async_contention(std::size_t tasks)
+{
+  static_thread_pool pool{4};
+  async_mutex        mutex;
+  long               counter = 0;
+
+  auto const elapsed = iol_bench::time(
+      [&]
+      {
+        std::vector<awaitable<void>> loops;
+        for (std::size_t t = 0; t < tasks; ++t)
+          loops.push_back(lock_loop(pool, mutex, counter, locks / tasks));
+        sync_wait(all(std::move(loops)));
+      });
+  iol_bench::do_not_optimize(counter);
+
+  char label[64];
+  std::snprintf(label, sizeof(label), "async_mutex, tasks: %zu", tasks);
+  iol_bench::report(label, locks, elapsed);
+}
+
+// the same on blocking mutexes, a waiting task holds on to its worker
+template <typename Mutex>
+void blocking_contention(char const* name, std::size_t tasks)
+{
+  static_thread_pool pool{4};
+  Mutex              mutex;
+  long               counter = 0;
+
+  auto const elapsed = iol_bench::time(
+      [&]
+      {
+        for (std::size_t t = 0; t < tasks; ++t)
+          pool.post(
+              [&]
+              {
+                for (std::size_t i = 0; i < locks / tasks; ++i) {
+                  std::scoped_lock<Mutex> lock{mutex};
+                  ++counter;
+                }
+              });
+        pool.wait();
+      });
+  iol_bench::do_not_optimize(counter);
+
+  char label[64];
+  std::snprintf(label, sizeof(label), "%s, tasks: %zu", name, tasks);
+  iol_bench::report(label, locks, elapsed);
+}
+
+/*
+ * threads plain threads share one counter and do work iterations of something else between
+ * taking the lock, the more of it the less they run into each other.
+ * */
+template <typename Mutex>
+void threads_locking(char const* name, std::size_t threads, std::size_t work)
+{
+  Mutex mutex;
+  long  counter = 0;
+
+  auto const elapsed = iol_bench::time(
+      [&]
+      {
+        std::vector<std::thread> running;
+        for (std::size_t t = 0; t < threads; ++t)
+          running.emplace_back(
+              [&]
+              {
+                for (std::size_t i = 0; i < locks / threads; ++i) {
+                  {
+                    std::scoped_lock<Mutex> lock{mutex};
+                    ++counter;
+                  }
+                  for (std::size_t w = 0; w < work; ++w)
+                    iol_bench::do_not_optimize(w);
+                }
+              });
+        for (auto& t : running)
+          t.join();
+      });
+  iol_bench::do_not_optimize(counter);
+
+  char label[64];
+  std::snprintf(label, sizeof(label), "%s, threads: %zu, work: %zu", name, threads, work);
+  iol_bench::report(label, locks, elapsed);
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_BENCH(async_mutex_contention)
+{
+  for (std::size_t tasks : {1, 4, 16, 64}) {
+    local::async_contention(tasks);
+    local::blocking_contention<iol::detail::fast_mutex>("fast_mutex", tasks);
+    local::blocking_contention<std::mutex>("std::mutex", tasks);
+  }
+}
+
+IOL_BENCH(fast_mutex_contention)
+{
+  struct {
+    std::size_t threads;
+    std::size_t work;
+  } const cases[] = {{1, 0}, {2, 200}, {4, 50}, {8, 0}};
+
+  // uncontended, light, moderate and heavy contention
+  for (auto [threads, work] : cases) {
+    local::threads_locking<iol::detail::fast_mutex>("fast_mutex", threads, work);
+    local::threads_locking<std::mutex>("std::mutex", threads, work);
+  }
+}
@@ -0,0 +1,112 @@
+#include "bench.hpp"
+
+#include <iol/detail/fast_mutex.hpp>
+#include <iol/detail/mpsc_operation_queue.hpp>
+#include <iol/detail/operation_queue.hpp>
+
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+constexpr std::size_t per_producer = 1'000'000;
+
+struct noop_operation : detail::operation_base {
+  noop_operation() : detail::operation_base{[](void*, detail::operation_base*) {}, nullptr} {}
+};
+
+// the queue static_thread_pool used before, a plain list under a lock
+struct locked_queue {
+
+  void enqueue(detail::operation_ptr&& op)
+  {
+    std::scoped_lock<detail::fast_mutex> lock{mutex};
+    queue.enqueue(std::move(op));
+  }
+
+  // takes everything at once, the consumer side of the old pool took one per lock
+  std::size_t drain()
+  {
+    detail::operation_queue taken;
+    {
+      std::scoped_lock<detail::fast_mutex> lock{mutex};
+      taken.enqueue(std::move(queue));
+    }
+    std::size_t n = 0;
+    for (; !taken.empty(); ++n)
+      (void)taken.deque().release();
+    return n;
+  }
+
+  detail::fast_mutex      mutex;
+  detail::operation_queue queue;
+};
+
+struct lock_free_queue {
+
+  void enqueue(detail::operation_ptr&& op) { queue.enqueue(std::move(op)); }
+
+  std::size_t drain()
+  {
+    std::size_t n = 0;
+    while (auto op = queue.try_deque()) {
+      (void)op.release();
+      ++n;
+    }
+    return n;
+  }
+
+  detail::mpsc_operation_queue queue;
+};
+
+template <typename Queue>
+void producers_and_one_consumer(char const* name, std::size_t producers)
+{
+  std::vector<std::vector<noop_operation>> ops(producers);
+  for (auto& o : ops)
+    o.resize(per_producer);
+
+  Queue      queue;
+  auto const total = producers * per_producer;
+
+  auto const elapsed = iol_bench::time(
+      [&]
+      {
+        std::vector<std::thread> threads;
+        for (std::size_t p = 0; p < producers; ++p)
+          threads.emplace_back(
+              [&, p]
+              {
+                for (auto& op : ops[p])
+                  queue.enqueue(detail::operation_ptr{&op});
+              });
+        for (std::size_t consumed = 0; consumed < total;)
+          consumed += queue.drain();
+        for (auto& t : threads)
+          t.join();
+      });
+
+  char label[64];
+  std::snprintf(label, sizeof(label), "%s, producers: %zu", name, producers);
+  iol_bench::report(label, total, elapsed);
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_BENCH(operation_queue_producers_and_one_consumer)
+{
+  for (std::size_t producers : {1, 2, 4, 8}) {
+    local::producers_and_one_consumer<local::locked_queue>("locked operation_queue", producers);
+    local::producers_and_one_consumer<local::lock_free_queue>("mpsc_operation_queue", producers);
+  }
+}
@@ -0,0 +1,187 @@
+#include "bench.hpp"
+
+#include <iol/get_allocator.hpp>
+#include <iol/static_thread_pool.hpp>
+
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <thread>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+constexpr std::size_t tasks = 1'000'000;
+
+/*
+ * A few tasks fan out into many small ones posted from inside the pool, all of them go
+ * through the shared queue.
+ * */
+void fan_out(static_thread_pool::options const& opts, char const* label)
+{
+  constexpr std::size_t roots = 100;
+
+  std::atomic_size_t ran{0};
+  auto const         elapsed = iol_bench::time(
+      [&]
+      {
+        static_thread_pool pool{4, opts};
+        for (std::size_t r = 0; r < roots; ++r)
+          pool.post(
+              [&]
+              {
+                for (std::size_t i = 0; i < tasks / roots; ++i)
+                  pool.post([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+              });
+        pool.wait();
+      });
+  iol_bench::report(label, ran.load(), elapsed);
+}
+
+/*
+ * The pool goes idle between posts, the time from post() until the task runs is what it takes
+ * to get a worker going again.
+ * */
+void wake_up_latency(std::size_t spin_count, std::chrono::microseconds gap, char const* label)
+{
+  constexpr std::size_t rounds = 2000;
+
+  static_thread_pool                     pool{1, {.spin_count = spin_count}};
+  std::atomic<iol_bench::clock_type::rep> ran_at{0};
+  iol_bench::clock_type::duration        total{};
+
+  for (std::size_t i = 0; i < rounds; ++i) {
+    std::this_thread::sleep_for(gap);
+    ran_at.store(0, std::memory_order_relaxed);
+    auto const posted = iol_bench::clock_type::now();
+    pool.post(
+        [&]
+        {
+          ran_at.store(
+              iol_bench::clock_type::now().time_since_epoch().count(), std::memory_order_release);
+        });
+    iol_bench::clock_type::rep at;
+    while (!(at = ran_at.load(std::memory_order_acquire)))
+      std::this_thread::yield();
+    total += iol_bench::clock_type::duration{at} - posted.time_since_epoch();
+  }
+  iol_bench::report(label, rounds, total);
+}
+
+// plain operator new, what every post cost before the thread caching allocator
+template <typename T>
+struct heap_allocator : std::allocator<T> {
+
+  heap_allocator() = default;
+
+  template <typename U>
+  heap_allocator(heap_allocator<U> const&) noexcept
+  {
+  }
+};
+
+struct counting_task {
+  std::atomic_size_t* ran;
+
+  void operator()() const { ran->fetch_add(1, std::memory_order_relaxed); }
+};
+
+struct heap_counting_task : counting_task {
+  friend heap_allocator<void> tag_invoke(get_allocator_t, heap_counting_task const&) noexcept
+  {
+    return {};
+  }
+};
+
+/*
+ * Posts from outside the pool in waves, blocks get allocated on this thread and freed on the
+ * worker, then from inside where both happen on the same thread.
+ * */
+template <typename Task>
+void allocations_per_post(char const* name)
+{
+  constexpr std::size_t waves = 10000;
+  constexpr std::size_t wave = 100;
+
+  static_thread_pool pool{2};
+  std::atomic_size_t ran{0};
+
+  auto const run = [&](char const* where, auto&& post)
+  {
+    auto const before = iol_bench::allocation_count();
+    auto const start = ran.load();
+    auto const elapsed = iol_bench::time(
+        [&]
+        {
+          for (std::size_t w = 0; w < waves; ++w) {
+            post();
+            while (ran.load(std::memory_order_relaxed) - start != (w + 1) * wave)
+              std::this_thread::yield();
+          }
+        });
+    auto const allocations = iol_bench::allocation_count() - before;
+
+    char label[64];
+    std::snprintf(label, sizeof(label), "%s, posted from %s", name, where);
+    iol_bench::report(label, waves * wave, elapsed);
+    iol_bench::report(label, "allocations/op", double(allocations) / (waves * wave));
+  };
+
+  run("outside",
+      [&]
+      {
+        for (std::size_t i = 0; i < wave; ++i)
+          pool.post(Task{&ran});
+      });
+  run("a worker",
+      [&]
+      {
+        pool.post(
+            [&]
+            {
+              for (std::size_t i = 0; i < wave; ++i)
+                pool.post(Task{&ran});
+            });
+      });
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_BENCH(static_thread_pool_fan_out_batch_size)
+{
+  for (std::size_t batch_size : {1, 4, 16, 64}) {
+    char label[64];
+    std::snprintf(label, sizeof(label), "shared queue, batch_size: %zu", batch_size);
+    local::fan_out({.batch_size = batch_size}, label);
+  }
+  local::fan_out(
+      {.mode = iol::static_thread_pool::scheduling_mode::work_stealing}, "work stealing");
+}
+
+IOL_BENCH(static_thread_pool_wake_up_latency)
+{
+  using namespace std::chrono_literals;
+
+  for (auto gap : {10us, 100us, 1000us}) {
+    for (std::size_t spin_count : {0, 4000, 40000}) {
+      char label[64];
+      std::snprintf(
+          label, sizeof(label), "idle for %lld us, spin_count: %zu",
+          static_cast<long long>(gap.count()), spin_count);
+      local::wake_up_latency(spin_count, gap, label);
+    }
+  }
+}
+
+IOL_BENCH(static_thread_pool_allocations_per_post)
+{
+  local::allocations_per_post<local::counting_task>("thread_caching_allocator");
+  local::allocations_per_post<local::heap_counting_task>("operator new");
+}
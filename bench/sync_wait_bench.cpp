@@ -0,0 +1,140 @@
+#include "bench.hpp"
+
+#include <iol/awaitable.hpp>
+#include <iol/detail/simple_manual_reset_event.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+
+#if defined(linux)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+constexpr std::size_t rounds = 1'000'000;
+
+awaitable<int> ready()
+{
+  co_return 1;
+}
+
+awaitable<int> on_pool(static_thread_pool& pool)
+{
+  co_await pool.schedule();
+  co_return 1;
+}
+
+/*
+ * The task is done before sync_wait() waits, the event is set by the time it looks.
+ * */
+void completed_inline()
+{
+  long       sum = 0;
+  auto const elapsed = iol_bench::time(
+      [&]
+      {
+        for (std::size_t i = 0; i < rounds; ++i)
+          sum += sync_wait(ready());
+      });
+  iol_bench::do_not_optimize(sum);
+  iol_bench::report("sync_wait, completed inline", rounds, elapsed);
+}
+
+/*
+ * The task finishes on a pool thread, the caller usually sleeps until then.
+ * */
+void completed_on_pool()
+{
+  constexpr std::size_t trips = 20000;
+
+  static_thread_pool pool{1};
+  long               sum = 0;
+  auto const         elapsed = iol_bench::time(
+      [&]
+      {
+        for (std::size_t i = 0; i < trips; ++i)
+          sum += sync_wait(on_pool(pool));
+      });
+  iol_bench::do_not_optimize(sum);
+  iol_bench::report("sync_wait, completed on a pool thread", trips, elapsed);
+}
+
+/*
+ * set() with nobody waiting, against the FUTEX_WAKE it used to make every time.
+ * */
+void set_without_a_waiter()
+{
+  auto const elapsed = iol_bench::time(
+      []
+      {
+        for (std::size_t i = 0; i < rounds; ++i) {
+          detail::simple_manual_reset_event event;
+          event.set();
+          event.wait();
+        }
+      });
+  iol_bench::report("set() and wait(), nobody sleeping", rounds, elapsed);
+
+#if defined(linux)
+  auto const with_wake = iol_bench::time(
+      []
+      {
+        for (std::size_t i = 0; i < rounds; ++i) {
+          detail::simple_manual_reset_event event;
+          std::uint32_t                     word = 1;
+          event.set();
+          syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+          event.wait();
+        }
+      });
+  iol_bench::report("the same plus an unconditional FUTEX_WAKE", rounds, with_wake);
+#endif
+}
+
+/*
+ * A pool thread sets the event while this one waits, spinning first or going straight to sleep.
+ * */
+void set_from_another_thread(std::size_t spin_count)
+{
+  constexpr std::size_t trips = 20000;
+
+  static_thread_pool pool{1};
+  auto const         elapsed = iol_bench::time(
+      [&]
+      {
+        for (std::size_t i = 0; i < trips; ++i) {
+          detail::simple_manual_reset_event event;
+          pool.post([&] { event.set(); });
+          event.wait(spin_count);
+        }
+      });
+
+  char label[64];
+  std::snprintf(label, sizeof(label), "set() from a pool thread, spin_count: %zu", spin_count);
+  iol_bench::report(label, trips, elapsed);
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_BENCH(sync_wait_round_trip)
+{
+  local::completed_inline();
+  local::completed_on_pool();
+  local::set_without_a_waiter();
+  for (std::size_t spin_count : {0, 1000, 10000})
+    local::set_from_another_thread(spin_count);
+}
@@ -0,0 +1,178 @@
+#include "bench.hpp"
+
+#include <iol/detail/timer_wheel.hpp>
+#include <iol/execution/sender.hpp>
+#include <iol/execution/timed_scheduler.hpp>
+#include <iol/static_thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+using detail::timer_node;
+using detail::timer_wheel;
+
+constexpr std::size_t timers = 1'000'000;
+
+// spread over about a million ticks, so the timers land on the first four levels
+std::vector<timer_wheel::tick_type> expiries()
+{
+  std::vector<timer_wheel::tick_type> result(timers);
+  std::uint64_t                       state = 42;
+  for (auto& expiry : result) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    expiry = 1 + (state >> 44);
+  }
+  return result;
+}
+
+/*
+ * Inserts every timer, cancels every other one and runs the wheel until the rest expired.
+ * */
+void wheel(std::vector<timer_wheel::tick_type> const& ticks)
+{
+  timer_wheel             wheel;
+  std::vector<timer_node> nodes(timers);
+
+  auto const inserted = iol_bench::time(
+      [&]
+      {
+        for (std::size_t i = 0; i < timers; ++i)
+          wheel.insert(nodes[i], ticks[i]);
+      });
+  iol_bench::report("timer_wheel, insert", timers, inserted);
+
+  auto const erased = iol_bench::time(
+      [&]
+      {
+        for (std::size_t i = 0; i < timers; i += 2)
+          wheel.erase(nodes[i]);
+      });
+  iol_bench::report("timer_wheel, cancel", timers / 2, erased);
+
+  std::size_t expired = 0;
+  auto const  advanced = iol_bench::time(
+      [&]
+      {
+        while (!wheel.empty())
+          for (auto* node = wheel.advance(wheel.next_tick()); node; node = node->next_timer)
+            ++expired;
+      });
+  iol_bench::report("timer_wheel, expire", expired, advanced);
+}
+
+// what a sorted container costs for the same work
+void ordered_map(std::vector<timer_wheel::tick_type> const& ticks)
+{
+  using map_type = std::multimap<timer_wheel::tick_type, timer_node*>;
+
+  map_type                        map;
+  std::vector<timer_node>         nodes(timers);
+  std::vector<map_type::iterator> handles(timers);
+
+  auto const inserted = iol_bench::time(
+      [&]
+      {
+        for (std::size_t i = 0; i < timers; ++i)
+          handles[i] = map.emplace(ticks[i], &nodes[i]);
+      });
+  iol_bench::report("std::multimap, insert", timers, inserted);
+
+  auto const erased = iol_bench::time(
+      [&]
+      {
+        for (std::size_t i = 0; i < timers; i += 2)
+          map.erase(handles[i]);
+      });
+  iol_bench::report("std::multimap, cancel", timers / 2, erased);
+
+  std::size_t expired = 0;
+  auto const  advanced = iol_bench::time(
+      [&]
+      {
+        for (; !map.empty(); ++expired)
+          map.erase(map.begin());
+      });
+  iol_bench::report("std::multimap, expire", expired, advanced);
+}
+
+struct count_stopped {
+  std::atomic_size_t* stopped;
+
+  friend void tag_invoke(execution::set_value_t, count_stopped&&) noexcept {}
+
+  friend void tag_invoke(execution::set_error_t, count_stopped&&, std::exception_ptr) noexcept {}
+
+  friend void tag_invoke(execution::set_stopped_t, count_stopped&& r) noexcept
+  {
+    r.stopped->fetch_add(1, std::memory_order_relaxed);
+  }
+};
+
+using scheduler_type = decltype(std::declval<static_thread_pool&>().get_scheduler());
+
+using timer_op = execution::connect_result_t<
+    decltype(execution::schedule_after(std::declval<scheduler_type>(), std::chrono::hours{})),
+    count_stopped>;
+
+// operation states can't move, the deque keeps them in place
+struct started {
+  started(scheduler_type sched, std::chrono::hours delay, std::atomic_size_t& stopped)
+    : op{execution::connect(execution::schedule_after(sched, delay), count_stopped{&stopped})}
+  {
+    execution::start(op);
+  }
+
+  timer_op op;
+};
+
+/*
+ * A million timers hours out started on a pool, then the pool goes away and stops them.
+ * */
+void pool_timers()
+{
+  std::atomic_size_t  stopped{0};
+  std::deque<started> ops;
+
+  auto pool = std::make_unique<static_thread_pool>(1);
+  auto sched = pool->get_scheduler();
+  // the timer thread starts with the first timer
+  ops.emplace_back(sched, std::chrono::hours{1}, stopped);
+
+  auto const scheduled = iol_bench::time(
+      [&]
+      {
+        for (std::size_t i = 1; i < timers; ++i)
+          ops.emplace_back(sched, std::chrono::hours{1 + i % 24}, stopped);
+      });
+  iol_bench::report("static_thread_pool, schedule_after", timers - 1, scheduled);
+
+  auto const destroyed = iol_bench::time([&] { pool.reset(); });
+  iol_bench::report("static_thread_pool, stop pending timers", stopped.load(), destroyed);
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_BENCH(timer_wheel_million_pending_timers)
+{
+  auto const ticks = local::expiries();
+  local::wheel(ticks);
+  local::ordered_map(ticks);
+  local::pool_timers();
+}
@@ -0,0 +1,103 @@
+#ifndef IOL_ASYNC_AUTO_RESET_EVENT_HPP
+#define IOL_ASYNC_AUTO_RESET_EVENT_HPP
+
+#include <iol/detail/config.hpp>
+
+//
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+
+namespace iol
+{
+
+class async_auto_reset_event;
+
+class async_auto_reset_event_operation
+{
+
+public:
+
+  explicit async_auto_reset_event_operation(async_auto_reset_event& event) noexcept
+    : event_{event}, next_{nullptr}, continuation_{nullptr}
+  {
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  // false if a pending set() was consumed right away
+  bool await_suspend(std::coroutine_handle<> continuation) noexcept;
+
+  void await_resume() const noexcept {}
+
+private:
+
+  friend async_auto_reset_event;
+
+  async_auto_reset_event&           event_;
+  async_auto_reset_event_operation* next_;
+  std::coroutine_handle<>           continuation_;
+};
+
+/*
+ * Every set() lets exactly one co_await through, either one that is already waiting or the
+ * next one to arrive. Waiters are resumed in arrival order.
+ *
+ * The state counts set() calls and waiters, whenever both are non zero the thread that made
+ * them so pairs them up and resumes the waiters, nobody else touches the waiter list.
+ * */
+class async_auto_reset_event
+{
+
+public:
+
+  explicit async_auto_reset_event(bool initially_set = false) noexcept
+    : state_{initially_set ? set_increment : 0}, new_waiters_{nullptr}, waiters_{nullptr}
+  {
+  }
+
+  async_auto_reset_event(async_auto_reset_event&&) = delete;
+
+  void set() noexcept;
+
+  void reset() noexcept;
+
+  async_auto_reset_event_operation operator co_await() noexcept
+  {
+    return async_auto_reset_event_operation{*this};
+  }
+
+private:
+
+  friend async_auto_reset_event_operation;
+
+  static constexpr std::uint64_t waiter_increment = 1;
+
+  static constexpr std::uint64_t set_increment = std::uint64_t{1} << 32;
+
+  static constexpr std::uint32_t waiter_count(std::uint64_t state) noexcept
+  {
+    return static_cast<std::uint32_t>(state);
+  }
+
+  static constexpr std::uint32_t set_count(std::uint64_t state) noexcept
+  {
+    return static_cast<std::uint32_t>(state >> 32);
+  }
+
+  /*
+   * pre-condition: the caller raised both counts above zero
+   * */
+  void resume_waiters(std::uint64_t state) noexcept;
+
+  std::atomic<std::uint64_t>                     state_;
+  std::atomic<async_auto_reset_event_operation*> new_waiters_;
+
+  // waiters in arrival order, only touched while resuming
+  async_auto_reset_event_operation* waiters_;
+};
+
+}  // namespace iol
+
+#endif  // IOL_ASYNC_AUTO_RESET_EVENT_HPP
@@ -0,0 +1,307 @@
+#ifndef IOL_ASYNC_GENERATOR_HPP
+#define IOL_ASYNC_GENERATOR_HPP
+
+#include <iol/detail/config.hpp>
+#include <iol/detail/frame_allocating_promise.hpp>
+#include <iol/detail/trampoline.hpp>
+
+//
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace iol
+{
+
+template <typename T>
+class async_generator;
+
+namespace detail
+{
+
+/*
+ * The producer and the consumer take turns, every yield and the final suspend transfer
+ * straight back to whichever coroutine asked for the next element.
+ * */
+class async_generator_promise_base : public frame_allocating_promise
+{
+
+  struct consumer_awaitable {
+
+    bool await_ready() const noexcept { return false; }
+
+#if IOL_SYMMETRIC_TRANSFER
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<>) noexcept
+    {
+      return consumer_;
+    }
+#else
+    void await_suspend(std::coroutine_handle<> producer) noexcept
+    {
+      trampoline::transfer(producer, consumer_);
+    }
+#endif
+
+    void await_resume() const noexcept {}
+
+    std::coroutine_handle<> consumer_;
+  };
+
+public:
+
+  async_generator_promise_base() noexcept : consumer_{nullptr}, exception_{nullptr} {}
+
+  void set_consumer(std::coroutine_handle<> consumer) noexcept { consumer_ = consumer; }
+
+  void rethrow_if_exception()
+  {
+    if (exception_)
+      std::rethrow_exception(std::exchange(exception_, nullptr));
+  }
+
+  /* Coroutine members */
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  consumer_awaitable final_suspend() noexcept { return {consumer_}; }
+
+  void return_void() noexcept {}
+
+  void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+protected:
+
+  consumer_awaitable resume_consumer() noexcept { return {consumer_}; }
+
+private:
+
+  std::coroutine_handle<> consumer_;
+  std::exception_ptr      exception_;
+};
+
+template <typename T>
+class async_generator_promise final : public async_generator_promise_base
+{
+
+public:
+
+  using value_type = std::remove_cvref_t<T>;
+
+  using reference = std::conditional_t<std::is_reference_v<T>, T, T&>;
+
+  using pointer = std::add_pointer_t<reference>;
+
+  async_generator_promise() noexcept : value_{nullptr} {}
+
+  async_generator<T> get_return_object() noexcept;
+
+  // the yielded object outlives the suspension, only its address is kept
+  auto yield_value(std::remove_reference_t<reference>& value) noexcept
+  {
+    value_ = std::addressof(value);
+    return resume_consumer();
+  }
+
+  auto yield_value(std::remove_reference_t<reference>&& value) noexcept
+  {
+    value_ = std::addressof(value);
+    return resume_consumer();
+  }
+
+  reference value() const noexcept { return static_cast<reference>(*value_); }
+
+private:
+
+  pointer value_;
+};
+
+}  // namespace detail
+
+/*
+ * A generator whose body may co_await, consumed with
+ *
+ *   for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it)
+ *
+ * An exception escaping the body is rethrown from the co_await that resumed it.
+ * */
+template <typename T>
+class [[nodiscard]] async_generator
+{
+
+public:
+
+  using promise_type = detail::async_generator_promise<T>;
+
+private:
+
+  using coroutine_handle = std::coroutine_handle<promise_type>;
+
+  template <typename Derived>
+  class resume_producer
+  {
+
+  public:
+
+    explicit resume_producer(coroutine_handle handle) noexcept : handle_{handle} {}
+
+    bool await_ready() const noexcept { return !handle_ || handle_.done(); }
+
+#if IOL_SYMMETRIC_TRANSFER
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) noexcept
+    {
+      handle_.promise().set_consumer(consumer);
+      return handle_;
+    }
+#else
+    void await_suspend(std::coroutine_handle<> consumer)
+    {
+      handle_.promise().set_consumer(consumer);
+      detail::trampoline::transfer(consumer, handle_);
+    }
+#endif
+
+    decltype(auto) await_resume()
+    {
+      if (handle_ && handle_.done())
+        handle_.promise().rethrow_if_exception();
+      return static_cast<Derived*>(this)->result();
+    }
+
+  protected:
+
+    coroutine_handle handle_;
+  };
+
+public:
+
+  class iterator
+  {
+
+    struct increment_awaitable : resume_producer<increment_awaitable> {
+
+      increment_awaitable(iterator& iter) noexcept
+        : resume_producer<increment_awaitable>{iter.handle_}, iter_{iter}
+      {
+      }
+
+      iterator& result() noexcept { return iter_; }
+
+      iterator& iter_;
+    };
+
+  public:
+
+    using value_type = typename promise_type::value_type;
+
+    using reference = typename promise_type::reference;
+
+    using pointer = typename promise_type::pointer;
+
+    using iterator_category = std::input_iterator_tag;
+
+    using difference_type = std::ptrdiff_t;
+
+    iterator() noexcept : handle_{nullptr} {}
+
+    /*
+     * pre-condition: *this != end()
+     * */
+    increment_awaitable operator++() noexcept { return {*this}; }
+
+    reference operator*() const noexcept { return handle_.promise().value(); }
+
+    pointer operator->() const noexcept { return std::addressof(**this); }
+
+    friend bool operator==(iterator const& iter, std::default_sentinel_t) noexcept
+    {
+      return !iter.handle_ || iter.handle_.done();
+    }
+
+  private:
+
+    friend async_generator;
+
+    explicit iterator(coroutine_handle handle) noexcept : handle_{handle} {}
+
+    coroutine_handle handle_;
+  };
+
+private:
+
+  struct begin_awaitable : resume_producer<begin_awaitable> {
+
+    using resume_producer<begin_awaitable>::resume_producer;
+
+    iterator result() noexcept { return iterator{this->handle_}; }
+  };
+
+public:
+
+  async_generator() noexcept : handle_{nullptr} {}
+
+  async_generator(async_generator&& other) noexcept
+    : handle_{std::exchange(other.handle_, nullptr)}
+  {
+  }
+
+  async_generator& operator=(async_generator other) noexcept
+  {
+    other.swap(*this);
+    return *this;
+  }
+
+  ~async_generator()
+  {
+    if (handle_)
+      handle_.destroy();
+  }
+
+  /*
+   * Runs the body up to its first yield.
+   *
+   * pre-condition: called once
+   * */
+  begin_awaitable begin() noexcept { return begin_awaitable{handle_}; }
+
+  std::default_sentinel_t end() const noexcept { return {}; }
+
+  void swap(async_generator& other) noexcept
+  {
+    using std::swap;
+    swap(handle_, other.handle_);
+  }
+
+private:
+
+  friend promise_type;
+
+  explicit async_generator(coroutine_handle handle) noexcept : handle_{handle} {}
+
+  coroutine_handle handle_;
+};
+
+template <typename T>
+void swap(async_generator<T>& lhs, async_generator<T>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+namespace detail
+{
+
+template <typename T>
+async_generator<T> async_generator_promise<T>::get_return_object() noexcept
+{
+  return async_generator<T>{
+      std::coroutine_handle<async_generator_promise<T>>::from_promise(*this)};
+}
+
+}  // namespace detail
+
+}  // namespace iol
+
+#endif  // IOL_ASYNC_GENERATOR_HPP
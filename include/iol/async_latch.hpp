@@ -0,0 +1,48 @@
+#ifndef IOL_ASYNC_LATCH_HPP
+#define IOL_ASYNC_LATCH_HPP
+
+#include <iol/async_manual_reset_event.hpp>
+#include <iol/detail/config.hpp>
+
+//
+
+#include <atomic>
+#include <cstddef>
+
+namespace iol
+{
+
+/*
+ * co_await suspends until count_down() brought the count to zero.
+ * */
+class async_latch
+{
+
+public:
+
+  explicit async_latch(std::ptrdiff_t count) noexcept : count_{count}, event_{count <= 0} {}
+
+  async_latch(async_latch&&) = delete;
+
+  bool is_ready() const noexcept { return event_.is_set(); }
+
+  void count_down(std::ptrdiff_t n = 1) noexcept
+  {
+    if (count_.fetch_sub(n, std::memory_order_acq_rel) <= n)
+      event_.set();
+  }
+
+  async_manual_reset_event_operation operator co_await() noexcept
+  {
+    return event_.operator co_await();
+  }
+
+private:
+
+  std::atomic<std::ptrdiff_t> count_;
+  async_manual_reset_event    event_;
+};
+
+}  // namespace iol
+
+#endif  // IOL_ASYNC_LATCH_HPP
@@ -0,0 +1,90 @@
+#ifndef IOL_ASYNC_MANUAL_RESET_EVENT_HPP
+#define IOL_ASYNC_MANUAL_RESET_EVENT_HPP
+
+#include <iol/detail/config.hpp>
+
+//
+
+#include <atomic>
+#include <coroutine>
+
+namespace iol
+{
+
+class async_manual_reset_event;
+
+class async_manual_reset_event_operation
+{
+
+public:
+
+  explicit async_manual_reset_event_operation(async_manual_reset_event& event) noexcept
+    : event_{event}, next_{nullptr}, continuation_{nullptr}
+  {
+  }
+
+  bool await_ready() const noexcept;
+
+  // false if the event got set in the meantime
+  bool await_suspend(std::coroutine_handle<> continuation) noexcept;
+
+  void await_resume() const noexcept {}
+
+private:
+
+  friend async_manual_reset_event;
+
+  async_manual_reset_event&           event_;
+  async_manual_reset_event_operation* next_;
+  std::coroutine_handle<>             continuation_;
+};
+
+/*
+ * co_await suspends until the event is set, set() resumes every waiting coroutine inline and
+ * lets later ones through until reset().
+ * */
+class async_manual_reset_event
+{
+
+public:
+
+  explicit async_manual_reset_event(bool initially_set = false) noexcept
+    : state_{initially_set ? static_cast<void*>(this) : nullptr}
+  {
+  }
+
+  async_manual_reset_event(async_manual_reset_event&&) = delete;
+
+  ~async_manual_reset_event()
+  {
+    IOL_ASSERT(!state_.load(std::memory_order_relaxed) || is_set());
+  }
+
+  bool is_set() const noexcept { return state_.load(std::memory_order_acquire) == this; }
+
+  void set() noexcept;
+
+  // no effect unless the event is set
+  void reset() noexcept;
+
+  async_manual_reset_event_operation operator co_await() noexcept
+  {
+    return async_manual_reset_event_operation{*this};
+  }
+
+private:
+
+  friend async_manual_reset_event_operation;
+
+  // this when set, otherwise the most recently queued waiter
+  std::atomic<void*> state_;
+};
+
+inline bool async_manual_reset_event_operation::await_ready() const noexcept
+{
+  return event_.is_set();
+}
+
+}  // namespace iol
+
+#endif  // IOL_ASYNC_MANUAL_RESET_EVENT_HPP
@@ -0,0 +1,170 @@
+#ifndef IOL_ASYNC_MUTEX_HPP
+#define IOL_ASYNC_MUTEX_HPP
+
+#include <iol/detail/config.hpp>
+
+//
+
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace iol
+{
+
+class async_mutex;
+
+class async_mutex_lock
+{
+
+public:
+
+  async_mutex_lock(async_mutex& mutex, std::adopt_lock_t) noexcept : mutex_{&mutex} {}
+
+  async_mutex_lock(async_mutex_lock&& other) noexcept
+    : mutex_{std::exchange(other.mutex_, nullptr)}
+  {
+  }
+
+  async_mutex_lock& operator=(async_mutex_lock&&) = delete;
+
+  ~async_mutex_lock();
+
+private:
+
+  async_mutex* mutex_;
+};
+
+class async_mutex_lock_operation
+{
+
+public:
+
+  explicit async_mutex_lock_operation(async_mutex& mutex) noexcept
+    : mutex_{mutex}, next_{nullptr}, continuation_{nullptr}, executor_{nullptr}, defer_{nullptr}
+  {
+  }
+
+  template <typename Executor>
+  async_mutex_lock_operation(async_mutex& mutex, Executor& executor) noexcept
+    : async_mutex_lock_operation{mutex}
+  {
+    executor_ = std::addressof(executor);
+    defer_ = [](void* executor, std::coroutine_handle<> handle) {
+      static_cast<Executor*>(executor)->defer([handle] { handle.resume(); });
+    };
+  }
+
+  bool await_ready() const noexcept { return false; }
+
+  // false if the mutex was free and is now held by the caller
+  bool await_suspend(std::coroutine_handle<> continuation) noexcept;
+
+  void await_resume() const noexcept {}
+
+protected:
+
+  friend async_mutex;
+
+  void resume() noexcept;
+
+  async_mutex&                mutex_;
+  async_mutex_lock_operation* next_;
+  std::coroutine_handle<>     continuation_;
+
+  void* executor_;
+  void (*defer_)(void*, std::coroutine_handle<>);
+};
+
+class async_mutex_scoped_lock_operation : public async_mutex_lock_operation
+{
+
+public:
+
+  using async_mutex_lock_operation::async_mutex_lock_operation;
+
+  [[nodiscard]] async_mutex_lock await_resume() const noexcept
+  {
+    return async_mutex_lock{mutex_, std::adopt_lock};
+  }
+};
+
+/*
+ * A mutex for coroutines, co_await lock() suspends the coroutine instead of blocking the
+ * thread. Waiters queue in a lock-free list and unlock() hands the mutex straight to the
+ * oldest one, resuming it inline or, for lock_on(executor), through executor.defer().
+ *
+ *   auto lock = co_await mutex.scoped_lock();
+ * */
+class async_mutex
+{
+
+public:
+
+  async_mutex() noexcept : state_{not_locked}, waiters_{nullptr} {}
+
+  async_mutex(async_mutex&&) = delete;
+
+  ~async_mutex() { IOL_ASSERT(state_.load(std::memory_order_relaxed) == not_locked); }
+
+  bool try_lock() noexcept
+  {
+    auto state = not_locked;
+    return state_.compare_exchange_strong(
+        state, locked_no_waiters, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] async_mutex_lock_operation lock() noexcept
+  {
+    return async_mutex_lock_operation{*this};
+  }
+
+  template <typename Executor>
+  [[nodiscard]] async_mutex_lock_operation lock_on(Executor& executor) noexcept
+  {
+    return async_mutex_lock_operation{*this, executor};
+  }
+
+  [[nodiscard]] async_mutex_scoped_lock_operation scoped_lock() noexcept
+  {
+    return async_mutex_scoped_lock_operation{*this};
+  }
+
+  template <typename Executor>
+  [[nodiscard]] async_mutex_scoped_lock_operation scoped_lock_on(Executor& executor) noexcept
+  {
+    return async_mutex_scoped_lock_operation{*this, executor};
+  }
+
+  /*
+   * pre-condition: the mutex is held by the caller
+   * */
+  void unlock();
+
+private:
+
+  friend async_mutex_lock_operation;
+
+  static constexpr std::uintptr_t not_locked = 1;
+
+  static constexpr std::uintptr_t locked_no_waiters = 0;
+
+  // not_locked, locked_no_waiters or the most recently queued waiter
+  std::atomic<std::uintptr_t> state_;
+
+  // waiters in arrival order, only touched by whoever holds the mutex
+  async_mutex_lock_operation* waiters_;
+};
+
+inline async_mutex_lock::~async_mutex_lock()
+{
+  if (mutex_)
+    mutex_->unlock();
+}
+
+}  // namespace iol
+
+#endif  // IOL_ASYNC_MUTEX_HPP
@@ -2,18 +2,17 @@
 #define IOL_AWAITABLE_HPP
 
 #include <iol/detail/config.hpp>
+#include <iol/detail/frame_allocating_promise.hpp>
+#include <iol/detail/trampoline.hpp>
 
 //
 
+#include <atomic>
 #include <coroutine>
 #include <exception>
 #include <utility>
 #include <variant>
 
-#if !IOL_SYMMETRIC_TRANSFER
-#include <atomic>
-#endif
-
 namespace iol
 {
 
@@ -23,7 +22,22 @@ class awaitable;
 namespace detail
 {
 
-class awaitable_promise_base
+struct awaitable_access;
+
+/*
+ * Shared by a group of awaitables started together, the last one to finish resumes the
+ * continuation.
+ * */
+struct awaitable_countdown {
+
+  // true for the last arrival
+  bool arrive() noexcept { return count.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+  std::atomic_size_t      count{0};
+  std::coroutine_handle<> continuation{nullptr};
+};
+
+class awaitable_promise_base : public frame_allocating_promise
 {
 
   struct final_awaitable {
@@ -37,6 +51,9 @@ class awaitable_promise_base
     {
       // returning the continuation will resume it
       auto& promise = awaitable_coroutine_handle.promise();
+      if (promise.countdown_)
+        return promise.countdown_->arrive() ? promise.countdown_->continuation
+                                            : std::noop_coroutine();
       return promise.continuation_;
     }
 #else
@@ -44,9 +61,10 @@ class awaitable_promise_base
     void await_suspend(std::coroutine_handle<Promise> awaitable_coroutine_handle) noexcept
     {
       auto& promise = awaitable_coroutine_handle.promise();
-      if (promise.state_.exchange(true, std::memory_order_acq_rel)) {
-        promise.continuation_.resume();
-      }
+      if (!promise.countdown_)
+        trampoline::transfer(awaitable_coroutine_handle, promise.continuation_);
+      else if (promise.countdown_->arrive())
+        trampoline::transfer(awaitable_coroutine_handle, promise.countdown_->continuation);
     }
 #endif
     void await_resume() const noexcept {}
@@ -54,20 +72,18 @@ class awaitable_promise_base
 
 public:
 
-  awaitable_promise_base() : continuation_{nullptr} {}
+  awaitable_promise_base() : continuation_{nullptr}, countdown_{nullptr} {}
 
-#if IOL_SYMMETRIC_TRANSFER
   void set_continuation(std::coroutine_handle<> continuation)
   {
     continuation_ = continuation;
   }
-#else
-  bool try_set_continuation(std::coroutine_handle<> continuation)
+
+  // arrive at countdown instead of resuming a continuation
+  void set_countdown(awaitable_countdown* countdown)
   {
-    continuation_ = continuation;
-    return !state_.exchange(true, std::memory_order_acq_rel);
+    countdown_ = countdown;
   }
-#endif
 
   /* Coroutine members */
 
@@ -85,17 +101,15 @@ public:
 private:
 
   std::coroutine_handle<> continuation_;
-
-#if !IOL_SYMMETRIC_TRANSFER
-  std::atomic<bool> state_;
-#endif
+  awaitable_countdown*    countdown_;
 };
 
 template <typename T>
 class awaitable_promise final : public awaitable_promise_base
 {
 
-  using value_type = std::conditional_t<std::is_reference_v<T>, std::reference_wrapper<T>, T>;
+  using value_type = std::conditional_t<
+      std::is_reference_v<T>, std::reference_wrapper<std::remove_reference_t<T>>, T>;
 
   using storage_type = std::variant<std::monostate, value_type, std::exception_ptr>;
 
@@ -167,6 +181,8 @@ class [[nodiscard]] awaitable
 
   friend detail::awaitable_promise<T>;
 
+  friend detail::awaitable_access;
+
   class initial_awaitable
   {
 
@@ -185,10 +201,10 @@ class [[nodiscard]] awaitable
       return handle_;
     }
 #else
-    bool await_suspend(std::coroutine_handle<> continuation)
+    void await_suspend(std::coroutine_handle<> continuation)
     {
-      handle_.resume();
-      return handle_.promise().try_set_continuation(continuation);
+      handle_.promise().set_continuation(continuation);
+      detail::trampoline::transfer(continuation, handle_);
     }
 #endif
 
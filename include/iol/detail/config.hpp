@@ -17,6 +17,20 @@
 #define IOL_LIKELY(EXPR) (!!(EXPR))
 #endif
 
+#if defined __GNUC__
+#define IOL_ALWAYS_INLINE __attribute__((always_inline)) inline
+#else
+#define IOL_ALWAYS_INLINE inline
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define IOL_SPIN_PAUSE() __builtin_ia32_pause()
+#elif defined(__aarch64__) || defined(__arm__)
+#define IOL_SPIN_PAUSE() __asm__ __volatile__("yield")
+#else
+#define IOL_SPIN_PAUSE() (void)0
+#endif
+
 #if defined NDEBUG
 #define IOL_ASSERT(CHECK) void(0)
 #else
@@ -37,7 +51,11 @@
 #define IOL_GCC 0
 #endif
 
-#if IOL_CLANG
+// Define IOL_SYMMETRIC_TRANSFER to override the detection, without it coroutines resume each
+// other through a per-thread trampoline
+#if defined(IOL_SYMMETRIC_TRANSFER)
+
+#elif IOL_CLANG
 
 #if __clang_major__ >= 7
 #define IOL_SYMMETRIC_TRANSFER 1
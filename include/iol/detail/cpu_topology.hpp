@@ -0,0 +1,36 @@
+#ifndef IOL_DETAIL_CPU_TOPOLOGY_HPP
+#define IOL_DETAIL_CPU_TOPOLOGY_HPP
+
+#include <vector>
+
+namespace iol::detail
+{
+
+struct cpu_info {
+  int id;
+  // unique per physical core, shared by its hardware threads
+  int core;
+  int node;
+};
+
+/*
+ * The cpus the calling thread is allowed to run on (sched_getaffinity), ordered by id, with
+ * their core and NUMA node read from /sys. A cpu whose topology can't be read counts as a core
+ * of its own on node 0. Empty if the affinity itself is unavailable.
+ * */
+std::vector<cpu_info> available_cpus();
+
+/*
+ * Restricts the calling thread to the given cpus, returns false if that failed or is not
+ * supported on this platform.
+ * */
+bool pin_this_thread(std::vector<int> const& cpus) noexcept;
+
+/*
+ * The cpu the calling thread is running on, -1 if unknown.
+ * */
+int current_cpu() noexcept;
+
+}  // namespace iol::detail
+
+#endif  // IOL_DETAIL_CPU_TOPOLOGY_HPP
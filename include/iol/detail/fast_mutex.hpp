@@ -5,11 +5,14 @@
 
 #if !defined(linux)
 #include <mutex>
-#include <condition_variable>
 #else
 #include <atomic>
+#include <cstdint>
 #endif
 
+#include <chrono>
+#include <condition_variable>
+
 namespace iol::detail
 {
 
@@ -70,20 +73,92 @@ class fast_mutex
     bool        locked_;
   };
 
+  /*
+   * notify_all() wakes a single waiter and moves the others onto the mutex, they are woken one
+   * at a time as it gets unlocked instead of all racing for it at once.
+   *
+   * pre-condition: every wait uses the same mutex
+   * */
   class cond_var
   {
    public:
 
+    cond_var() noexcept;
+
+    cond_var(cond_var&&) = delete;
+
+    void notify_one() noexcept;
+
+    void notify_all() noexcept;
+
     void wait(scoped_lock& lock);
+
+    template <typename Predicate>
+    void wait(scoped_lock& lock, Predicate pred)
+    {
+      while (!pred())
+        wait(lock);
+    }
+
+    std::cv_status wait_for(scoped_lock& lock, std::chrono::nanoseconds timeout);
+
+    template <typename Rep, typename Period, typename Predicate>
+    bool wait_for(
+        scoped_lock& lock, std::chrono::duration<Rep, Period> const& timeout, Predicate pred)
+    {
+      return wait_until(lock, std::chrono::steady_clock::now() + timeout, std::move(pred));
+    }
+
+    template <typename Clock, typename Duration>
+    std::cv_status wait_until(
+        scoped_lock& lock, std::chrono::time_point<Clock, Duration> const& deadline)
+    {
+      auto const remaining = deadline - Clock::now();
+      if (remaining <= remaining.zero())
+        return std::cv_status::timeout;
+      wait_for(lock, std::chrono::ceil<std::chrono::nanoseconds>(remaining));
+      return Clock::now() < deadline ? std::cv_status::no_timeout : std::cv_status::timeout;
+    }
+
+    template <typename Clock, typename Duration, typename Predicate>
+    bool wait_until(
+        scoped_lock& lock, std::chrono::time_point<Clock, Duration> const& deadline,
+        Predicate pred)
+    {
+      while (!pred()) {
+        if (wait_until(lock, deadline) == std::cv_status::timeout)
+          return pred();
+      }
+      return true;
+    }
+
+   private:
+
+#if defined(linux)
+    std::atomic<std::uint32_t> seq_;
+    std::atomic<std::uint32_t> waiters_;
+    std::atomic<fast_mutex*>   mutex_;
+#else
+    std::condition_variable cv_;
+#endif
   };
 
  private:
 
 #if defined(linux)
+  // spins for a while before going to sleep
+  void lock_slow();
+
+  // locks with the state saying there may be waiters, for threads that slept on the mutex
+  void lock_contended();
+
+  // 0 unlocked, 1 locked, 2 locked and there may be waiters
   std::atomic<std::uint32_t> state_;
+
+  // running average of the spins it took to get the mutex, bounds the next spin phase
+  std::atomic<std::uint32_t> spins_;
 #else
-  std::mutex              mut_{};
-  std::condition_variable cv_{};
+  std::mutex mut_;
 #endif
 };
 
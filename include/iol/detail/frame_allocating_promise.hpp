@@ -0,0 +1,173 @@
+#ifndef IOL_DETAIL_FRAME_ALLOCATING_PROMISE_HPP
+#define IOL_DETAIL_FRAME_ALLOCATING_PROMISE_HPP
+
+#include <iol/detail/config.hpp>
+#include <iol/get_allocator.hpp>
+#include <iol/thread_caching_allocator.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+namespace iol::detail
+{
+
+template <typename... Args>
+inline constexpr bool starts_with_allocator_arg = false;
+
+template <typename... Args>
+inline constexpr bool starts_with_allocator_arg<std::allocator_arg_t, Args...> = true;
+
+/*
+ * Base for promise types that picks where the coroutine frame lives:
+ *
+ *  - coroutine(std::allocator_arg, alloc, args...) allocates through alloc, for member
+ *    coroutines the allocator_arg comes right after the object
+ *  - otherwise coroutine(t, args...) allocates through get_allocator(t) if t customizes it
+ *  - otherwise the frame comes from thread_caching_allocator
+ *
+ * The frame is preceded by the function that frees it and its size, and followed by a copy of
+ * the allocator, so every operator delete can free it from the pointer alone.
+ * */
+class frame_allocating_promise
+{
+
+  struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) block {
+    std::byte bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+  };
+
+  using deallocate_fn = void (*)(void* base, std::size_t size) noexcept;
+
+  struct header {
+    deallocate_fn free_frame;
+    std::size_t   size;
+  };
+
+  static constexpr std::size_t align_up(std::size_t n, std::size_t alignment) noexcept
+  {
+    return (n + alignment - 1) & ~(alignment - 1);
+  }
+
+  // keeps the frame aligned like the blocks
+  static constexpr std::size_t header_size =
+      (sizeof(header) + sizeof(block) - 1) / sizeof(block) * sizeof(block);
+
+  template <typename Alloc>
+  struct layout {
+
+    using allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<block>;
+    using traits = std::allocator_traits<allocator>;
+
+    static_assert(std::same_as<typename traits::pointer, block*>);
+
+    static constexpr std::size_t allocator_offset(std::size_t size) noexcept
+    {
+      return align_up(header_size + size, alignof(allocator));
+    }
+
+    static constexpr std::size_t block_count(std::size_t size) noexcept
+    {
+      return (allocator_offset(size) + sizeof(allocator) + sizeof(block) - 1) / sizeof(block);
+    }
+  };
+
+  template <typename Alloc>
+  static void* allocate(std::size_t size, Alloc const& alloc)
+  {
+    using frame_layout = layout<Alloc>;
+    using allocator = typename frame_layout::allocator;
+
+    allocator a(alloc);
+    auto*     base = reinterpret_cast<std::byte*>(
+        frame_layout::traits::allocate(a, frame_layout::block_count(size)));
+    ::new (base) header{&deallocate<Alloc>, size};
+    ::new (base + frame_layout::allocator_offset(size)) allocator(std::move(a));
+    return base + header_size;
+  }
+
+  template <typename Alloc>
+  static void deallocate(void* base, std::size_t size) noexcept
+  {
+    using frame_layout = layout<Alloc>;
+    using allocator = typename frame_layout::allocator;
+
+    auto* stored = std::launder(reinterpret_cast<allocator*>(
+        static_cast<std::byte*>(base) + frame_layout::allocator_offset(size)));
+    allocator a(std::move(*stored));
+    stored->~allocator();
+    frame_layout::traits::deallocate(
+        a, static_cast<block*>(base), frame_layout::block_count(size));
+  }
+
+  static void release(void* frame) noexcept
+  {
+    auto* const  base = static_cast<std::byte*>(frame) - header_size;
+    header const h = *std::launder(reinterpret_cast<header*>(base));
+    h.free_frame(base, h.size);
+  }
+
+public:
+
+  static void* operator new(std::size_t size)
+  {
+    return allocate(size, thread_caching_allocator<>{});
+  }
+
+  // the templated forms inline so GCC doesn't pair the usual delete the coroutine frees the
+  // frame with against a template, which -Wmismatched-new-delete takes for a mismatch
+  template <typename Alloc, typename... Args>
+  IOL_ALWAYS_INLINE static void* operator new(
+      std::size_t size, std::allocator_arg_t, Alloc const& alloc, Args const&...)
+  {
+    return allocate(size, alloc);
+  }
+
+  template <typename This, typename Alloc, typename... Args>
+  IOL_ALWAYS_INLINE static void* operator new(
+      std::size_t size, This const&, std::allocator_arg_t, Alloc const& alloc, Args const&...)
+  {
+    return allocate(size, alloc);
+  }
+
+  template <typename T, typename... Args>
+    requires tag_invocable<get_allocator_t, T const&> &&
+        (!starts_with_allocator_arg<std::remove_cvref_t<Args>...>)
+  IOL_ALWAYS_INLINE static void* operator new(std::size_t size, T const& t, Args const&...)
+  {
+    return allocate(size, get_allocator(t));
+  }
+
+  static void operator delete(void* frame) noexcept
+  {
+    release(frame);
+  }
+
+  // the placement forms pair with the operator new overloads above
+  template <typename Alloc, typename... Args>
+  static void operator delete(
+      void* frame, std::allocator_arg_t, Alloc const&, Args const&...) noexcept
+  {
+    release(frame);
+  }
+
+  template <typename This, typename Alloc, typename... Args>
+  static void operator delete(
+      void* frame, This const&, std::allocator_arg_t, Alloc const&, Args const&...) noexcept
+  {
+    release(frame);
+  }
+
+  template <typename T, typename... Args>
+    requires tag_invocable<get_allocator_t, T const&> &&
+        (!starts_with_allocator_arg<std::remove_cvref_t<Args>...>)
+  static void operator delete(void* frame, T const&, Args const&...) noexcept
+  {
+    release(frame);
+  }
+};
+
+}  // namespace iol::detail
+
+#endif  // IOL_DETAIL_FRAME_ALLOCATING_PROMISE_HPP
@@ -0,0 +1,74 @@
+#ifndef IOL_DETAIL_MPSC_OPERATION_QUEUE_HPP
+#define IOL_DETAIL_MPSC_OPERATION_QUEUE_HPP
+
+#include <iol/detail/config.hpp>
+#include <iol/detail/operation_base.hpp>
+#include <iol/detail/operation_queue.hpp>
+
+#include <atomic>
+#include <cstddef>
+
+namespace iol::detail
+{
+
+/*
+ * Intrusive multi-producer/single-consumer queue linked through operation_base::next
+ * (Vyukov). Producers never block, a single exchange publishes an operation or a whole
+ * operation_queue.
+ *
+ * Only one thread may act as the consumer at any time, several consumers have to
+ * serialize on an external lock.
+ * */
+class mpsc_operation_queue
+{
+
+public:
+
+  mpsc_operation_queue() noexcept;
+
+  mpsc_operation_queue(mpsc_operation_queue&&) = delete;
+
+  ~mpsc_operation_queue();
+
+  void enqueue(operation_ptr&& operation) noexcept;
+
+  void enqueue(operation_queue&& queue) noexcept;
+
+  /*
+   * pre-condition: called by the consumer
+   * */
+  bool empty() const noexcept;
+
+  /*
+   * Safe to call from any thread, but only a hint, the answer may be stale or wrong while
+   * the consumer is busy with the queue.
+   * */
+  bool likely_empty() const noexcept;
+
+  /*
+   * pre-condition: called by the consumer
+   *
+   * May come back empty handed while a producer is half way through an enqueue, even
+   * though empty() is false.
+   * */
+  operation_ptr try_deque() noexcept;
+
+  /*
+   * pre-condition: called by the consumer
+   *
+   * Moves up to max operations onto the end of queue, returns how many were moved.
+   * */
+  std::size_t try_deque(operation_queue& queue, std::size_t max) noexcept;
+
+private:
+
+  void push(operation_base* first, operation_base* last) noexcept;
+
+  alignas(64) std::atomic<operation_base*> back_;
+  alignas(64) operation_base* front_;
+  operation_base stub_;
+};
+
+}  // namespace iol::detail
+
+#endif  // IOL_DETAIL_MPSC_OPERATION_QUEUE_HPP
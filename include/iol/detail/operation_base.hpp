@@ -20,8 +20,8 @@ using operation_ptr = std::unique_ptr<operation_base, operation_destroyer>;
 
 struct operation_base {
   using func = void (*)(void *, operation_base *);
-  func          invoke;
-  operation_ptr next;
+  func            invoke;
+  operation_base *next;
 };
 
 }  // namespace iol::detail
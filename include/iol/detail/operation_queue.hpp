@@ -18,6 +18,8 @@ public:
 
   operation_queue& operator=(operation_queue&& other) noexcept;
 
+  ~operation_queue();
+
   void swap(operation_queue& other) noexcept;
 
   bool empty() const noexcept;
@@ -30,8 +32,10 @@ public:
 
 private:
 
-  operation_ptr  head_;
-  operation_ptr* tail_;
+  friend class mpsc_operation_queue;
+
+  operation_base*  head_;
+  operation_base** tail_;
 };
 
 inline void swap(operation_queue& lhs, operation_queue& rhs) noexcept
@@ -9,10 +9,15 @@
 #endif
 
 #include <atomic>
+#include <cstddef>
 
 namespace iol::detail
 {
 
+/*
+ * On linux the state is 0 (not set), 1 (set) or 2 (not set and a thread sleeps on it), set()
+ * only makes a syscall in the last case.
+ * */
 class simple_manual_reset_event
 {
 
@@ -26,9 +31,14 @@ public:
 
   void set();
 
+  // no effect unless the event is set
   void reset();
 
-  void wait() const;
+  /*
+   * Polls the event up to spin_count times before going to sleep, worth it when set() is
+   * expected within a few microseconds.
+   * */
+  void wait(std::size_t spin_count = 0) const;
 
   bool is_set() const;
 
@@ -39,7 +49,7 @@ private:
   mutable std::condition_variable cv_;
   std::atomic_bool                state_;
 #else
-  std::atomic_int state_;
+  mutable std::atomic_int state_;
 #endif
 };
 
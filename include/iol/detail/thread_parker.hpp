@@ -0,0 +1,53 @@
+#ifndef IOL_DETAIL_THREAD_PARKER_HPP
+#define IOL_DETAIL_THREAD_PARKER_HPP
+
+#include <iol/detail/config.hpp>
+
+#if !defined(linux)
+#include <condition_variable>
+#include <mutex>
+#else
+#include <atomic>
+#include <cstdint>
+#endif
+
+namespace iol::detail
+{
+
+/*
+ * A parking slot for a single thread.
+ *
+ * park() blocks the owning thread until another thread calls unpark(). A call to unpark()
+ * that comes first is remembered, so the next park() returns straight away. unpark() only
+ * makes a syscall when the owner is actually asleep.
+ * */
+class thread_parker
+{
+
+public:
+
+  thread_parker() noexcept;
+
+  thread_parker(thread_parker&&) = delete;
+
+  /*
+   * pre-condition: called by the owning thread
+   * */
+  void park();
+
+  void unpark();
+
+private:
+
+#if !defined(linux)
+  std::mutex              mut_;
+  std::condition_variable cv_;
+  bool                    notified_;
+#else
+  std::atomic<std::uint32_t> state_;
+#endif
+};
+
+}  // namespace iol::detail
+
+#endif  // IOL_DETAIL_THREAD_PARKER_HPP
@@ -0,0 +1,98 @@
+#ifndef IOL_DETAIL_TIMER_WHEEL_HPP
+#define IOL_DETAIL_TIMER_WHEEL_HPP
+
+#include <iol/detail/config.hpp>
+
+//
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace iol::detail
+{
+
+struct timer_node {
+  timer_node* next_timer = nullptr;
+  // nullptr unless the timer waits in a wheel
+  timer_node*   prev_timer = nullptr;
+  std::uint64_t expiry = 0;
+};
+
+/*
+ * Hierarchical timing wheel, levels of 64 slots where a slot of level n spans 64^n ticks.
+ * A timer goes to the lowest level whose slot tells it apart from the current tick and moves
+ * down a level each time the wheel reaches its slot, inserting and erasing never look at other
+ * timers. Per level bitmaps of the occupied slots let advance() jump straight to the next
+ * tick with something to do.
+ * */
+class timer_wheel
+{
+
+ public:
+
+  using tick_type = std::uint64_t;
+
+  static constexpr std::size_t level_bits = 6;
+
+  static constexpr std::size_t slot_count = std::size_t{1} << level_bits;
+
+  static constexpr std::size_t level_count = 8;
+
+  // expiries are clamped to this, 2^48 ticks are way beyond any sane uptime
+  static constexpr tick_type max_tick = (tick_type{1} << (level_bits * level_count)) - 1;
+
+  static constexpr tick_type no_tick = std::numeric_limits<tick_type>::max();
+
+  timer_wheel() noexcept;
+
+  timer_wheel(timer_wheel&&) = delete;
+
+  ~timer_wheel() { IOL_ASSERT(empty()); }
+
+  tick_type now() const noexcept { return now_; }
+
+  bool empty() const noexcept;
+
+  /*
+   * Returns false without adding the timer if it is due already.
+   *
+   * pre-condition: node isn't in a wheel
+   * */
+  bool insert(timer_node& node, tick_type expiry) noexcept;
+
+  /*
+   * pre-condition: node waits in this wheel
+   * */
+  void erase(timer_node& node) noexcept;
+
+  // the earliest tick advance() has something to do at, no_tick if the wheel is empty
+  tick_type next_tick() const noexcept;
+
+  /*
+   * Moves the wheel forward to tick and takes out the timers that are due, linked through
+   * next_timer in no particular order.
+   * */
+  timer_node* advance(tick_type tick) noexcept;
+
+  // takes out every timer, linked through next_timer
+  timer_node* take_all() noexcept;
+
+ private:
+
+  // links node into the slot its expiry belongs to at the current tick
+  void link(timer_node& node) noexcept;
+
+  // the timers of a slot linked through next_timer, the slot is empty afterwards
+  timer_node* unlink_slot(std::size_t level, std::size_t slot) noexcept;
+
+  tick_type now_;
+
+  // circular lists, the heads are sentinels
+  std::array<timer_node, level_count * slot_count> slots_;
+  std::array<std::uint64_t, level_count>           occupied_;
+};
+
+}  // namespace iol::detail
+
+#endif  // IOL_DETAIL_TIMER_WHEEL_HPP
@@ -0,0 +1,87 @@
+#ifndef IOL_DETAIL_TRAMPOLINE_HPP
+#define IOL_DETAIL_TRAMPOLINE_HPP
+
+#include <iol/detail/config.hpp>
+
+#include <coroutine>
+#include <utility>
+
+#if !IOL_SYMMETRIC_TRANSFER
+
+namespace iol::detail
+{
+
+/*
+ * Without symmetric transfer, resuming one coroutine from another's await_suspend nests a
+ * stack frame per hop. Instead a loop resumes the coroutines one after the other: a transfer
+ * out of the coroutine the loop is resuming hands the next one to it and unwinds, so the stack
+ * depth stays constant.
+ *
+ * Any other transfer, from a coroutine that a blocking sync_wait or an event resumed inline
+ * for example, runs a loop of its own. Handing over to the outer loop would leave the next
+ * coroutine waiting for whoever resumed the caller, which may be blocked on it.
+ * */
+class trampoline
+{
+
+public:
+
+  /*
+   * pre-condition: called from the await_suspend of from
+   * */
+  static void transfer(std::coroutine_handle<> from, std::coroutine_handle<> handle)
+  {
+    auto& self = current_;
+    if (self.resuming_ && self.resuming_ == from) {
+      IOL_ASSERT(!self.pending_);
+      self.pending_ = handle;
+      return;
+    }
+
+    scope guard{self};
+    while (handle) {
+      self.resuming_ = handle;
+      handle.resume();
+      handle = std::exchange(self.pending_, nullptr);
+    }
+  }
+
+private:
+
+  // a loop on the stack, puts back the state of the one it interrupted when it leaves
+  struct scope {
+
+    explicit scope(trampoline& t) noexcept
+      : self{t},
+        resuming{std::exchange(t.resuming_, nullptr)},
+        pending{std::exchange(t.pending_, nullptr)}
+    {
+    }
+
+    scope(scope&&) = delete;
+
+    ~scope()
+    {
+      self.resuming_ = resuming;
+      self.pending_ = pending;
+    }
+
+    trampoline&             self;
+    std::coroutine_handle<> resuming;
+    std::coroutine_handle<> pending;
+  };
+
+  static thread_local trampoline current_;
+
+  // the coroutine the innermost loop is resuming
+  std::coroutine_handle<> resuming_ = nullptr;
+  std::coroutine_handle<> pending_ = nullptr;
+};
+
+inline thread_local trampoline trampoline::current_{};
+
+}  // namespace iol::detail
+
+#endif
+
+#endif  // IOL_DETAIL_TRAMPOLINE_HPP
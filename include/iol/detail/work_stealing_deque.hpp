@@ -0,0 +1,64 @@
+#ifndef IOL_DETAIL_WORK_STEALING_DEQUE_HPP
+#define IOL_DETAIL_WORK_STEALING_DEQUE_HPP
+
+#include <iol/detail/config.hpp>
+#include <iol/detail/operation_base.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace iol::detail
+{
+
+/*
+ * Chase-Lev deque of operations.
+ *
+ * The owning thread pushes and pops at the bottom (LIFO), any other thread may steal from
+ * the top (FIFO). Buffers replaced on growth are retired, not freed, until the deque is
+ * destroyed since a concurrent thief may still be reading from them.
+ * */
+class work_stealing_deque
+{
+
+public:
+
+  explicit work_stealing_deque(std::size_t capacity = 256);
+
+  work_stealing_deque(work_stealing_deque&&) = delete;
+
+  ~work_stealing_deque();
+
+  /*
+   * pre-condition: called from the owning thread
+   * */
+  void push(operation_ptr&& operation);
+
+  /*
+   * pre-condition: called from the owning thread
+   * */
+  operation_ptr pop() noexcept;
+
+  operation_ptr steal() noexcept;
+
+  bool empty() const noexcept;
+
+  std::size_t size() const noexcept;
+
+private:
+
+  class buffer;
+
+  buffer* grow(buffer* old, std::int64_t top, std::int64_t bottom);
+
+  alignas(64) std::atomic<std::int64_t> top_;
+  alignas(64) std::atomic<std::int64_t> bottom_;
+  std::atomic<buffer*> buffer_;
+
+  std::vector<std::unique_ptr<buffer>> buffers_;
+};
+
+}  // namespace iol::detail
+
+#endif  // IOL_DETAIL_WORK_STEALING_DEQUE_HPP
@@ -8,8 +8,14 @@
 #include <iol/execution/completion_signatures.hpp>
 #include <iol/execution/scheduler.hpp>
 
-#include <mutex>
+#if !defined(linux)
 #include <condition_variable>
+#include <mutex>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 
 namespace iol::execution
 {
@@ -118,16 +124,20 @@ constexpr run_loop_scheduler tag_invoke(
   return {s.loop_};
 }
 
+/*
+ * Producers push onto an intrusive lock-free stack, the thread running the loop takes the
+ * whole stack at once and works through it in push order. It only sleeps once the stack is
+ * empty, and the producer that finds it asleep wakes it.
+ *
+ * finish() pushes a marker behind everything queued so far, neither it nor a producer
+ * touches the loop after the push unless the loop thread needs waking.
+ * */
 class run_loop
 {
 
   template <receiver_of>
   friend struct op_state;
 
-  using work_count_t = std::size_t;
-
-  enum class state_t { /* starting, */ running, finishing };
-
   friend constexpr forward_progress_guarantee tag_invoke(
       get_forward_progress_guarantee_t, run_loop const&) noexcept
   {
@@ -146,20 +156,63 @@ class run_loop
 
   void run();
 
+  /*
+   * Runs one operation, blocking until there is one. Returns false once finish() was called
+   * and nothing is left.
+   * */
+  bool run_one();
+
+  /*
+   * Runs what is queued right now without blocking, operations those push wait for the next
+   * call. Returns how many ran.
+   * */
+  std::size_t poll();
+
+  // runs one queued operation without blocking, returns false if there was none
+  bool poll_one();
+
+  // polls until nothing is queued anymore, returns how many ran
+  std::size_t run_until_idle();
+
   void finish();
 
  private:
 
+  static constexpr std::uintptr_t empty = 0;
+
+  // empty and the loop thread is asleep, or about to be
+  static constexpr std::uintptr_t sleeping = 1;
+
   void push_back(opstate_base* op);
 
   opstate_base* pop_front();
 
-  opstate_base *head_, **tail_;
-  work_count_t  n_work_;
-  state_t       state_;
+  // nullptr if nothing is queued
+  opstate_base* try_pop_front() noexcept;
+
+  // moves everything pushed so far behind front_, returns false if there was nothing
+  bool take_pushed() noexcept;
+
+  void sleep();
+
+  // publishes op if the loop is still asleep and wakes it, false if it isn't anymore
+  bool wake(opstate_base* op);
+
+  // empty, sleeping or the most recently pushed operation
+  std::atomic<std::uintptr_t> head_;
+
+  // loop thread only, operations in push order, back_ is stale while front_ is empty
+  opstate_base* front_;
+  opstate_base* back_;
+  bool          finishing_;
+
+  std::atomic_bool finish_requested_;
+  opstate_base     finish_marker_;
 
+#if !defined(linux)
   std::mutex              mut_;
   std::condition_variable cv_;
+#endif
 };
 
 template <receiver_of R>
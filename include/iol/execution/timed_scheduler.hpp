@@ -0,0 +1,80 @@
+#ifndef IOL_EXECUTION_TIMED_SCHEDULER_HPP
+#define IOL_EXECUTION_TIMED_SCHEDULER_HPP
+
+#include <iol/tag_invoke.hpp>
+
+#include <iol/execution/scheduler.hpp>
+#include <iol/execution/sender.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace iol::execution
+{
+
+namespace _timed_scheduler
+{
+
+struct now_t
+{
+  template <typename S>
+    requires tag_invocable<now_t, std::remove_cvref_t<S> const&>
+  constexpr auto operator()(S&& s) const noexcept
+  {
+    static_assert(nothrow_tag_invocable<now_t, std::remove_cvref_t<S> const&>);
+    return tag_invoke(*this, std::as_const(s));
+  }
+};
+
+struct schedule_at_t
+{
+  template <typename S, typename TimePoint>
+    requires tag_invocable<schedule_at_t, S, TimePoint> &&
+        sender<tag_invoke_result_t<schedule_at_t, S, TimePoint>>
+  constexpr sender auto operator()(S&& s, TimePoint&& deadline) const
+      noexcept(nothrow_tag_invocable<schedule_at_t, S, TimePoint>)
+  {
+    return tag_invoke(*this, (S &&) s, (TimePoint &&) deadline);
+  }
+};
+
+struct schedule_after_t
+{
+  template <typename S, typename Duration>
+    requires tag_invocable<schedule_after_t, S, Duration> &&
+        sender<tag_invoke_result_t<schedule_after_t, S, Duration>>
+  constexpr sender auto operator()(S&& s, Duration&& delay) const
+      noexcept(nothrow_tag_invocable<schedule_after_t, S, Duration>)
+  {
+    return tag_invoke(*this, (S &&) s, (Duration &&) delay);
+  }
+};
+
+}  // namespace _timed_scheduler
+
+using _timed_scheduler::now_t;
+
+using _timed_scheduler::schedule_at_t;
+
+using _timed_scheduler::schedule_after_t;
+
+inline constexpr now_t now{};
+
+inline constexpr schedule_at_t schedule_at{};
+
+inline constexpr schedule_after_t schedule_after{};
+
+/*
+ * A scheduler that can also start work at a point in time of its own clock, or once a
+ * duration of it has passed.
+ * */
+template <typename S>
+concept timed_scheduler = scheduler<S> && requires(S&& s)
+{
+  schedule_at((S &&) s, now(s));
+  schedule_after((S &&) s, now(s) - now(s));
+};
+
+}  // namespace iol::execution
+
+#endif  // IOL_EXECUTION_TIMED_SCHEDULER_HPP
@@ -1,50 +1,236 @@
 #ifndef IOL_GENERATOR_HPP
 #define IOL_GENERATOR_HPP
 
+#include <iol/detail/config.hpp>
+#include <iol/detail/trampoline.hpp>
+
+//
+
 #include <coroutine>
+#include <exception>
 #include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
 #include <utility>
 
 namespace iol
 {
 
+/*
+ * co_yield elements_of(range) yields every element of range, see generator.
+ * */
+template <typename Range>
+struct elements_of {
+  Range range;
+};
+
+template <typename Range>
+elements_of(Range&&) -> elements_of<Range&&>;
+
+/*
+ * reference: the consumer sees the yielded object itself, nothing is copied
+ * value:     the yielded value is stored in the generator and the iterator moves it out
+ * */
+enum class yield_mode { reference, value };
+
+template <typename T, yield_mode Mode = yield_mode::reference>
+struct generator;
+
 template <typename T>
-struct [[nodiscard]] generator {
+using owning_generator = generator<T, yield_mode::value>;
+
+namespace detail
+{
+
+template <typename>
+inline constexpr bool is_elements_of = false;
+
+template <typename Range>
+inline constexpr bool is_elements_of<elements_of<Range>> = true;
+
+template <typename Range, typename Generator>
+inline constexpr bool is_rvalue_generator =
+    std::same_as<Range, Generator> || std::same_as<Range, Generator&&>;
 
+template <typename T, yield_mode Mode, typename Range>
+generator<T, Mode> generate_elements_of(Range range)
+{
+  for (auto&& element : range)
+    co_yield std::forward<decltype(element)>(element);
+}
+
+}  // namespace detail
+
+template <typename T, yield_mode Mode>
+struct [[nodiscard]] generator : std::ranges::view_interface<generator<T, Mode>> {
+
+  static_assert(Mode == yield_mode::reference || std::is_object_v<T>);
+
+  /*
+   * Generators yielding elements_of another generator form a stack, every promise knows the
+   * root and the root knows the innermost generator that is running. The consumer resumes
+   * that one directly, so nesting costs nothing per element.
+   * */
   struct promise_type {
 
     using coroutine_handle = std::coroutine_handle<promise_type>;
 
     using value_type = std::remove_reference_t<T>;
 
-    using reference_type = std::conditional_t<std::is_reference_v<T>, T, T&>;
+    using reference_type = std::conditional_t<
+        std::is_reference_v<T>, T, std::conditional_t<Mode == yield_mode::value, T&&, T&>>;
 
     using pointer_type = value_type*;
 
-    promise_type() : value_{nullptr} {}
+  private:
+
+    struct final_awaitable {
+
+      bool await_ready() const noexcept { return false; }
+
+#if IOL_SYMMETRIC_TRANSFER
+      std::coroutine_handle<> await_suspend(coroutine_handle handle) noexcept
+      {
+        if (auto* parent = handle.promise().leave())
+          return coroutine_handle::from_promise(*parent);
+        return std::noop_coroutine();
+      }
+#else
+      void await_suspend(coroutine_handle handle) noexcept
+      {
+        if (auto* parent = handle.promise().leave())
+          detail::trampoline::transfer(handle, coroutine_handle::from_promise(*parent));
+      }
+#endif
+
+      void await_resume() const noexcept {}
+    };
+
+    struct nested_awaitable {
+
+      bool await_ready() const noexcept { return !nested.handle_ || nested.handle_.done(); }
+
+#if IOL_SYMMETRIC_TRANSFER
+      std::coroutine_handle<> await_suspend(coroutine_handle handle) noexcept
+      {
+        nested.handle_.promise().enter(handle.promise());
+        return nested.handle_;
+      }
+#else
+      void await_suspend(coroutine_handle handle)
+      {
+        nested.handle_.promise().enter(handle.promise());
+        detail::trampoline::transfer(handle, nested.handle_);
+      }
+#endif
+
+      // what the nested generator threw surfaces at the co_yield
+      void await_resume() const
+      {
+        if (nested.handle_ && nested.handle_.promise().exception_)
+          std::rethrow_exception(nested.handle_.promise().exception_);
+      }
+
+      generator nested;
+    };
+
+    struct no_storage {
+    };
+
+    using storage_type =
+        std::conditional_t<Mode == yield_mode::value, std::optional<value_type>, no_storage>;
+
+  public:
+
+    promise_type()
+      : value_{nullptr}, root_{this}, parent_{nullptr}, leaf_{this}, exception_{nullptr}
+    {
+    }
 
     generator get_return_object() { return generator{coroutine_handle::from_promise(*this)}; }
 
     std::suspend_always initial_suspend() { return {}; }
 
-    std::suspend_always final_suspend() noexcept { return {}; }
+    final_awaitable final_suspend() noexcept { return {}; }
 
     template <typename U>
+      requires(!detail::is_elements_of<std::remove_cvref_t<U>>)
     std::suspend_always yield_value(U&& t)
     {
-      value_ = std::addressof(t);
+      if constexpr (Mode == yield_mode::value)
+        root_->value_ = std::addressof(root_->storage_.emplace(std::forward<U>(t)));
+      else
+        root_->value_ = std::addressof(t);
       return {};
     }
 
+    /*
+     * Takes over an rvalue generator, an lvalue one is iterated like any other range and
+     * stays with its owner.
+     *
+     * pre-condition: the nested generator hasn't been started
+     * */
+    template <typename Range>
+      requires detail::is_rvalue_generator<Range, generator>
+    nested_awaitable yield_value(elements_of<Range> elements)
+    {
+      return {std::move(elements.range)};
+    }
+
+    template <std::ranges::input_range Range>
+      requires(!detail::is_rvalue_generator<Range, generator>)
+    nested_awaitable yield_value(elements_of<Range> elements)
+    {
+      return {detail::generate_elements_of<T, Mode, Range>(static_cast<Range>(elements.range))};
+    }
+
+    void return_void() noexcept {}
+
     void await_transform() = delete;
 
-    [[noreturn]] void unhandled_exception() { throw; }
+    // kept until the parent or, for the root, resume() rethrows it, it never unwinds through
+    // the coroutine that resumed this one
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
 
     reference_type value() const noexcept { return static_cast<reference_type>(*value_); }
 
+    pointer_type address() const noexcept { return value_; }
+
+    /*
+     * pre-condition: called on the root
+     * */
+    void resume()
+    {
+      coroutine_handle::from_promise(*leaf_).resume();
+      if (exception_)
+        std::rethrow_exception(std::exchange(exception_, nullptr));
+    }
+
   private:
 
-    pointer_type value_;
+    void enter(promise_type& parent) noexcept
+    {
+      root_ = parent.root_;
+      parent_ = &parent;
+      root_->leaf_ = this;
+    }
+
+    promise_type* leave() noexcept
+    {
+      if (parent_)
+        root_->leaf_ = parent_;
+      return parent_;
+    }
+
+    pointer_type  value_;
+    promise_type* root_;
+    promise_type* parent_;
+    promise_type* leaf_;
+
+    std::exception_ptr exception_;
+
+    [[no_unique_address]] storage_type storage_;
   };
 
   constexpr generator() noexcept : handle_{nullptr} {}
@@ -53,8 +239,6 @@ struct [[nodiscard]] generator {
 
   generator(generator&& other) noexcept : handle_{other.handle_} { other.handle_ = nullptr; }
 
-  generator& operator=(generator const&) = delete;
-
   generator& operator=(generator other) noexcept
   {
     other.swap(*this);
@@ -86,17 +270,17 @@ struct [[nodiscard]] generator {
 
     iterator() noexcept : handle_{nullptr} {}
 
-    iterator& operator++() noexcept
+    iterator& operator++()
     {
-      handle_.resume();
+      handle_.promise().resume();
       return *this;
     }
 
-    void operator++(int) noexcept { (void)++(*this); }
+    void operator++(int) { (void)++(*this); }
 
     reference operator*() const { return handle_.promise().value(); }
 
-    pointer operator->() const { return &handle_.promise().value(); }
+    pointer operator->() const { return handle_.promise().address(); }
 
     friend bool operator==(iterator const& iter, std::default_sentinel_t) noexcept
     {
@@ -121,7 +305,7 @@ struct [[nodiscard]] generator {
   iterator begin()
   {
     if (handle_ && !handle_.done())
-      handle_.resume();
+      handle_.promise().resume();
     return {handle_};
   }
 
@@ -142,8 +326,8 @@ private:
   coroutine_handle handle_;
 };
 
-template <typename T>
-void swap(generator<T>& lhs, generator<T>& rhs) noexcept
+template <typename T, yield_mode Mode>
+void swap(generator<T, Mode>& lhs, generator<T, Mode>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
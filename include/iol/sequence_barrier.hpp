@@ -0,0 +1,108 @@
+#ifndef IOL_SEQUENCE_BARRIER_HPP
+#define IOL_SEQUENCE_BARRIER_HPP
+
+#include <iol/detail/config.hpp>
+
+//
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <type_traits>
+
+namespace iol
+{
+
+class sequence_barrier;
+
+class sequence_barrier_operation
+{
+
+public:
+
+  sequence_barrier_operation(sequence_barrier& barrier, std::size_t target) noexcept
+    : barrier_{barrier}, target_{target}, next_{nullptr}, continuation_{nullptr}
+  {
+  }
+
+  bool await_ready() const noexcept;
+
+  void await_suspend(std::coroutine_handle<> continuation) noexcept;
+
+  // the last published sequence, at least target
+  std::size_t await_resume() const noexcept;
+
+private:
+
+  friend sequence_barrier;
+
+  sequence_barrier&           barrier_;
+  std::size_t                 target_;
+  sequence_barrier_operation* next_;
+  std::coroutine_handle<>     continuation_;
+};
+
+/*
+ * A producer publishes increasing sequence numbers, consumers co_await
+ * wait_until_published(n) and get resumed inline by the publish that reaches n. Sequence
+ * numbers may wrap, they are compared by distance.
+ * */
+class sequence_barrier
+{
+
+public:
+
+  // nothing is published yet, the first sequence is initial_sequence + 1
+  explicit sequence_barrier(std::size_t initial_sequence = static_cast<std::size_t>(-1)) noexcept
+    : last_published_{initial_sequence}, waiters_{nullptr}
+  {
+  }
+
+  sequence_barrier(sequence_barrier&&) = delete;
+
+  ~sequence_barrier() { IOL_ASSERT(!waiters_.load(std::memory_order_relaxed)); }
+
+  std::size_t last_published() const noexcept
+  {
+    return last_published_.load(std::memory_order_acquire);
+  }
+
+  /*
+   * pre-condition: one publisher at a time, sequence doesn't go backwards
+   * */
+  void publish(std::size_t sequence) noexcept;
+
+  [[nodiscard]] sequence_barrier_operation wait_until_published(std::size_t target) noexcept
+  {
+    return sequence_barrier_operation{*this, target};
+  }
+
+private:
+
+  friend sequence_barrier_operation;
+
+  static bool reached(std::size_t published, std::size_t target) noexcept
+  {
+    return static_cast<std::make_signed_t<std::size_t>>(published - target) >= 0;
+  }
+
+  // resumes every queued waiter whose target was published
+  void resume_published() noexcept;
+
+  std::atomic<std::size_t>                 last_published_;
+  std::atomic<sequence_barrier_operation*> waiters_;
+};
+
+inline bool sequence_barrier_operation::await_ready() const noexcept
+{
+  return sequence_barrier::reached(barrier_.last_published(), target_);
+}
+
+inline std::size_t sequence_barrier_operation::await_resume() const noexcept
+{
+  return barrier_.last_published();
+}
+
+}  // namespace iol
+
+#endif  // IOL_SEQUENCE_BARRIER_HPP
@@ -0,0 +1,344 @@
+#ifndef IOL_SHARED_AWAITABLE_HPP
+#define IOL_SHARED_AWAITABLE_HPP
+
+#include <iol/detail/config.hpp>
+#include <iol/detail/frame_allocating_promise.hpp>
+
+//
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <utility>
+#include <variant>
+
+namespace iol
+{
+
+template <typename = void>
+class shared_awaitable;
+
+namespace detail
+{
+
+struct shared_awaitable_waiter {
+  std::coroutine_handle<> continuation;
+  shared_awaitable_waiter* next;
+};
+
+/*
+ * state_ is this promise until the first awaiter starts the coroutine, then a lock-free stack
+ * of waiters, and done_tag once the result is available.
+ * */
+class shared_awaitable_promise_base : public frame_allocating_promise
+{
+
+  struct final_awaitable {
+
+    bool await_ready() const noexcept { return false; }
+
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> shared_coroutine_handle) noexcept
+    {
+      shared_coroutine_handle.promise().complete();
+    }
+
+    void await_resume() const noexcept {}
+  };
+
+public:
+
+  shared_awaitable_promise_base() noexcept
+    : state_{this}, ref_count_{1}, executor_{nullptr}, post_{nullptr}
+  {
+  }
+
+  /* Coroutine members */
+
+  std::suspend_always initial_suspend() noexcept { return {}; }
+
+  final_awaitable final_suspend() noexcept { return {}; }
+
+  /* Shared state */
+
+  bool is_ready() const noexcept { return state_.load(std::memory_order_acquire) == &done_tag; }
+
+  void add_ref() noexcept { ref_count_.fetch_add(1, std::memory_order_relaxed); }
+
+  // true if this was the last reference
+  bool release() noexcept { return ref_count_.fetch_sub(1, std::memory_order_acq_rel) == 1; }
+
+  /*
+   * Starts the coroutine if nobody did yet. Returns false if the result is already available,
+   * otherwise waiter gets resumed once it is.
+   * */
+  bool try_await(shared_awaitable_waiter* waiter, std::coroutine_handle<> coroutine)
+  {
+    void* const not_started = this;
+
+    auto state = state_.load(std::memory_order_acquire);
+    if (state == not_started &&
+        state_.compare_exchange_strong(state, nullptr, std::memory_order_relaxed)) {
+      coroutine.resume();
+      state = state_.load(std::memory_order_acquire);
+    }
+
+    do {
+      if (state == &done_tag)
+        return false;
+      waiter->next = static_cast<shared_awaitable_waiter*>(state);
+    } while (!state_.compare_exchange_weak(
+        state, waiter, std::memory_order_release, std::memory_order_acquire));
+    return true;
+  }
+
+  /*
+   * pre-condition: the coroutine hasn't been started
+   * */
+  template <typename Executor>
+  void resume_on(Executor& executor) noexcept
+  {
+    executor_ = std::addressof(executor);
+    post_ = [](void* executor, std::coroutine_handle<> handle) {
+      static_cast<Executor*>(executor)->post([handle] { handle.resume(); });
+    };
+  }
+
+private:
+
+  void complete() noexcept
+  {
+    auto* waiter = static_cast<shared_awaitable_waiter*>(
+        state_.exchange(&done_tag, std::memory_order_acq_rel));
+    while (waiter) {
+      // the waiter lives in the frame it resumes
+      auto* next = waiter->next;
+      resume(waiter->continuation);
+      waiter = next;
+    }
+  }
+
+  void resume(std::coroutine_handle<> continuation) noexcept
+  {
+    if (post_) {
+      try {
+        post_(executor_, continuation);
+        return;
+      } catch (...) {
+        // fall back to resuming inline
+      }
+    }
+    continuation.resume();
+  }
+
+  static inline char done_tag = 0;
+
+  std::atomic<void*> state_;
+  std::atomic_size_t ref_count_;
+
+  void* executor_;
+  void (*post_)(void*, std::coroutine_handle<>);
+};
+
+template <typename T>
+class shared_awaitable_promise final : public shared_awaitable_promise_base
+{
+
+  using value_type = std::conditional_t<
+      std::is_reference_v<T>, std::reference_wrapper<std::remove_reference_t<T>>, T>;
+
+  using storage_type = std::variant<std::monostate, value_type, std::exception_ptr>;
+
+  enum { empty, value, error };
+
+public:
+
+  using reference = std::conditional_t<std::is_reference_v<T>, T, T const&>;
+
+  shared_awaitable<T> get_return_object();
+
+  template <typename U>
+  requires requires(storage_type& s, U&& u) { s = std::forward<U>(u); }
+  void return_value(U&& u) { storage_ = std::forward<U>(u); }
+
+  void unhandled_exception() { storage_ = std::current_exception(); }
+
+  reference get_value() const
+  {
+    IOL_ASSERT(storage_.index() != empty);
+    if (storage_.index() == error)
+      std::rethrow_exception(std::get<error>(storage_));
+    return std::get<value>(storage_);
+  }
+
+private:
+
+  storage_type storage_;
+};
+
+template <>
+class shared_awaitable_promise<void> final : public shared_awaitable_promise_base
+{
+
+public:
+
+  shared_awaitable<void> get_return_object();
+
+  void return_void() {}
+
+  void unhandled_exception() { exception_ = std::current_exception(); }
+
+  void get_value() const
+  {
+    if (exception_)
+      std::rethrow_exception(exception_);
+  }
+
+private:
+
+  std::exception_ptr exception_;
+};
+
+}  // namespace detail
+
+/*
+ * Like awaitable, but any number of coroutines may await it, at the same time or after it
+ * completed. The first one starts the coroutine, everybody gets a reference to the same result.
+ * Copies share the coroutine, the last one destroys it.
+ * */
+template <typename T>
+class [[nodiscard]] shared_awaitable
+{
+
+  friend detail::shared_awaitable_promise<T>;
+
+public:
+
+  using promise_type = detail::shared_awaitable_promise<T>;
+
+private:
+
+  using coroutine_handle = std::coroutine_handle<promise_type>;
+
+  class awaiter : detail::shared_awaitable_waiter
+  {
+
+  public:
+
+    explicit awaiter(coroutine_handle handle) noexcept
+      : detail::shared_awaitable_waiter{nullptr, nullptr}, handle_{handle}
+    {
+    }
+
+    bool await_ready() const noexcept { return !handle_ || handle_.promise().is_ready(); }
+
+    bool await_suspend(std::coroutine_handle<> continuation)
+    {
+      this->continuation = continuation;
+      return handle_.promise().try_await(this, handle_);
+    }
+
+    decltype(auto) await_resume() const
+    {
+      IOL_ASSERT(handle_);
+      return handle_.promise().get_value();
+    }
+
+  private:
+
+    coroutine_handle handle_;
+  };
+
+public:
+
+  shared_awaitable() noexcept : handle_{nullptr} {}
+
+  shared_awaitable(shared_awaitable const& other) noexcept : handle_{other.handle_}
+  {
+    if (handle_)
+      handle_.promise().add_ref();
+  }
+
+  shared_awaitable(shared_awaitable&& other) noexcept
+    : handle_{std::exchange(other.handle_, nullptr)}
+  {
+  }
+
+  shared_awaitable& operator=(shared_awaitable other) noexcept
+  {
+    swap(other);
+    return *this;
+  }
+
+  ~shared_awaitable()
+  {
+    if (handle_ && handle_.promise().release())
+      handle_.destroy();
+  }
+
+  void swap(shared_awaitable<T>& other) noexcept
+  {
+    using std::swap;
+    swap(handle_, other.handle_);
+  }
+
+  bool is_ready() const noexcept
+  {
+    return !handle_ || handle_.promise().is_ready();
+  }
+
+  /*
+   * Waiters are handed to executor.post() instead of being resumed inline once the result is
+   * available.
+   *
+   * pre-condition: nothing awaited this yet
+   * */
+  template <typename Executor>
+  void resume_on(Executor& executor) noexcept
+  {
+    IOL_ASSERT(handle_);
+    handle_.promise().resume_on(executor);
+  }
+
+  awaiter operator co_await() const noexcept { return awaiter{handle_}; }
+
+  friend bool operator==(shared_awaitable const& lhs, shared_awaitable const& rhs) noexcept
+  {
+    return lhs.handle_ == rhs.handle_;
+  }
+
+private:
+
+  explicit shared_awaitable(coroutine_handle handle) noexcept : handle_{handle} {}
+
+  coroutine_handle handle_;
+};
+
+template <typename T>
+void swap(shared_awaitable<T>& lhs, shared_awaitable<T>& rhs) noexcept
+{
+  return lhs.swap(rhs);
+}
+
+namespace detail
+{
+
+template <typename T>
+shared_awaitable<T> shared_awaitable_promise<T>::get_return_object()
+{
+  return shared_awaitable<T>{
+      std::coroutine_handle<shared_awaitable_promise<T>>::from_promise(*this)};
+}
+
+inline shared_awaitable<void> shared_awaitable_promise<void>::get_return_object()
+{
+  return shared_awaitable<void>{
+      std::coroutine_handle<shared_awaitable_promise<void>>::from_promise(*this)};
+}
+
+}  // namespace detail
+
+}  // namespace iol
+
+#endif  // IOL_SHARED_AWAITABLE_HPP
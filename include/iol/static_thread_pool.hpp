@@ -3,25 +3,285 @@
 
 #include <iol/detail/allocation_utility.hpp>
 #include <iol/detail/config.hpp>
+#include <iol/detail/fast_mutex.hpp>
+#include <iol/detail/mpsc_operation_queue.hpp>
 #include <iol/detail/operation_base.hpp>
 #include <iol/detail/operation_queue.hpp>
+#include <iol/detail/thread_parker.hpp>
+#include <iol/detail/timer_wheel.hpp>
 #include <iol/get_allocator.hpp>
+#include <iol/thread_caching_allocator.hpp>
+
+#include <iol/execution/completion_signatures.hpp>
+#include <iol/execution/receiver.hpp>
+#include <iol/execution/scheduler.hpp>
+#include <iol/execution/sender.hpp>
+#include <iol/execution/timed_scheduler.hpp>
 
 //
 
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
+#include <concepts>
 #include <coroutine>
+#include <exception>
+#include <memory>
 #include <mutex>
+#include <ranges>
 #include <thread>
 #include <vector>
 
 namespace iol
 {
 
+class static_thread_pool;
+
+namespace _static_thread_pool
+{
+
+/*
+ * The operation state is the queued operation, starting it never allocates. An operation still
+ * queued when the pool is destroyed completes with set_stopped.
+ * */
+template <execution::receiver_of R>
+struct op_state : detail::operation_base {
+
+  template <typename Receiver>
+  op_state(Receiver&& receiver, static_thread_pool* pool)
+    : detail::operation_base{invoke_impl, nullptr}, r_{(Receiver&&)receiver}, pool_{pool}
+  {
+  }
+
+  op_state(op_state&&) = delete;
+
+private:
+
+  static void invoke_impl(void* owner, detail::operation_base* base)
+  {
+    auto& self = *static_cast<op_state*>(base);
+    if (!owner) {
+      execution::set_stopped((R&&)self.r_);
+      return;
+    }
+    try {
+      execution::set_value((R&&)self.r_);
+    } catch (...) {
+      execution::set_error((R&&)self.r_, std::current_exception());
+    }
+  }
+
+  [[no_unique_address]] R r_;
+
+  static_thread_pool* pool_;
+
+  void start() noexcept;
+
+  friend void tag_invoke(execution::start_t, op_state<R>& self) noexcept { self.start(); }
+};
+
+using clock_type = std::chrono::steady_clock;
+
+inline clock_type::time_point deadline_after(clock_type::duration delay) noexcept
+{
+  auto const now = clock_type::now();
+  return delay < clock_type::time_point::max() - now ? now + delay
+                                                     : clock_type::time_point::max();
+}
+
+/*
+ * Waits in the pool's timer wheel until the deadline, then gets queued like any other
+ * operation.
+ * */
+struct timer_operation : detail::operation_base, detail::timer_node {
+
+  timer_operation(detail::operation_base::func fn, clock_type::time_point when) noexcept
+    : detail::operation_base{fn, nullptr}, detail::timer_node{}, deadline{when}, cancelled{false}
+  {
+  }
+
+  timer_operation(timer_operation&&) = delete;
+
+  clock_type::time_point deadline;
+
+  // set when it got queued before the deadline
+  bool cancelled;
+};
+
+template <execution::receiver_of R>
+struct timer_op_state : timer_operation {
+
+  template <typename Receiver>
+  timer_op_state(Receiver&& receiver, static_thread_pool* pool, clock_type::time_point deadline)
+    : timer_operation{invoke_impl, deadline}, r_{(Receiver&&)receiver}, pool_{pool}
+  {
+  }
+
+private:
+
+  static void invoke_impl(void* owner, detail::operation_base* base)
+  {
+    auto& self = *static_cast<timer_op_state*>(base);
+    if (!owner) {
+      execution::set_stopped((R&&)self.r_);
+      return;
+    }
+    try {
+      execution::set_value((R&&)self.r_);
+    } catch (...) {
+      execution::set_error((R&&)self.r_, std::current_exception());
+    }
+  }
+
+  [[no_unique_address]] R r_;
+
+  static_thread_pool* pool_;
+
+  void start() noexcept;
+
+  friend void tag_invoke(execution::start_t, timer_op_state<R>& self) noexcept { self.start(); }
+};
+
+class static_thread_pool_scheduler;
+
+class static_thread_pool_sender
+  : public execution::completion_signatures<
+        execution::set_value_t(), execution::set_error_t(std::exception_ptr),
+        execution::set_stopped_t()>
+{
+
+public:
+
+  constexpr static_thread_pool_sender(static_thread_pool* pool) : pool_{pool} {}
+
+  template <execution::receiver_of R>
+  friend op_state<std::decay_t<R>> tag_invoke(
+      execution::connect_t, static_thread_pool_sender const& self,
+      R&& r) noexcept(std::is_nothrow_constructible_v<std::decay_t<R>, R>)
+  {
+    return {(R&&)r, self.pool_};
+  }
+
+  template <typename CPO>
+  friend constexpr static_thread_pool_scheduler tag_invoke(
+      execution::get_completion_scheduler_t<CPO>, static_thread_pool_sender const& s) noexcept;
+
+private:
+
+  static_thread_pool* pool_;
+};
+
+class static_thread_pool_timer_sender
+  : public execution::completion_signatures<
+        execution::set_value_t(), execution::set_error_t(std::exception_ptr),
+        execution::set_stopped_t()>
+{
+
+public:
+
+  constexpr static_thread_pool_timer_sender(
+      static_thread_pool* pool, clock_type::time_point deadline)
+    : pool_{pool}, deadline_{deadline}
+  {
+  }
+
+  template <execution::receiver_of R>
+  friend timer_op_state<std::decay_t<R>> tag_invoke(
+      execution::connect_t, static_thread_pool_timer_sender const& self,
+      R&& r) noexcept(std::is_nothrow_constructible_v<std::decay_t<R>, R>)
+  {
+    return {(R&&)r, self.pool_, self.deadline_};
+  }
+
+  template <typename CPO>
+  friend constexpr static_thread_pool_scheduler tag_invoke(
+      execution::get_completion_scheduler_t<CPO>,
+      static_thread_pool_timer_sender const& s) noexcept;
+
+private:
+
+  static_thread_pool*    pool_;
+  clock_type::time_point deadline_;
+};
+
+class static_thread_pool_scheduler
+{
+
+public:
+
+  constexpr static_thread_pool_scheduler(static_thread_pool* pool) : pool_{pool} {}
+
+  friend constexpr bool operator==(
+      static_thread_pool_scheduler const& lhs, static_thread_pool_scheduler const& rhs) noexcept
+  {
+    return lhs.pool_ == rhs.pool_;
+  }
+
+  friend constexpr bool operator!=(
+      static_thread_pool_scheduler const& lhs, static_thread_pool_scheduler const& rhs) noexcept
+  {
+    return lhs.pool_ != rhs.pool_;
+  }
+
+  friend constexpr static_thread_pool_sender tag_invoke(
+      execution::schedule_t, static_thread_pool_scheduler const& sched) noexcept
+  {
+    return {sched.pool_};
+  }
+
+  friend clock_type::time_point tag_invoke(
+      execution::now_t, static_thread_pool_scheduler const&) noexcept
+  {
+    return clock_type::now();
+  }
+
+  friend constexpr static_thread_pool_timer_sender tag_invoke(
+      execution::schedule_at_t, static_thread_pool_scheduler const& sched,
+      clock_type::time_point deadline) noexcept
+  {
+    return {sched.pool_, deadline};
+  }
+
+  friend static_thread_pool_timer_sender tag_invoke(
+      execution::schedule_after_t, static_thread_pool_scheduler const& sched,
+      clock_type::duration delay) noexcept
+  {
+    return {sched.pool_, deadline_after(delay)};
+  }
+
+private:
+
+  static_thread_pool* pool_;
+};
+
+template <typename CPO>
+constexpr static_thread_pool_scheduler tag_invoke(
+    execution::get_completion_scheduler_t<CPO>, static_thread_pool_sender const& s) noexcept
+{
+  return {s.pool_};
+}
+
+template <typename CPO>
+constexpr static_thread_pool_scheduler tag_invoke(
+    execution::get_completion_scheduler_t<CPO>, static_thread_pool_timer_sender const& s) noexcept
+{
+  return {s.pool_};
+}
+
+}  // namespace _static_thread_pool
+
+using _static_thread_pool::static_thread_pool_scheduler;
+
 class static_thread_pool
 {
 
+  template <execution::receiver_of>
+  friend struct _static_thread_pool::op_state;
+
+  template <execution::receiver_of>
+  friend struct _static_thread_pool::timer_op_state;
+
+  using timer_operation = _static_thread_pool::timer_operation;
+
   struct schedule_coro_operation : detail::operation_base {
 
     schedule_coro_operation() : schedule_coro_operation(nullptr) {}
@@ -55,6 +315,40 @@ class static_thread_pool
     std::coroutine_handle<> continuation_;
   };
 
+  struct schedule_timer_operation : timer_operation {
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> continuation) noexcept
+    {
+      continuation_ = continuation;
+      pool_->add_timer(*this);
+    }
+
+    // false if the timer got cancelled
+    bool await_resume() const noexcept { return !cancelled; }
+
+    /*
+     * Resumes the awaiting coroutine without waiting for the deadline. Returns false if there
+     * is nothing to cancel, the timer fired already or isn't awaited yet.
+     * */
+    bool cancel() noexcept { return pool_->cancel_timer(*this); }
+
+  private:
+
+    friend static_thread_pool;
+    schedule_timer_operation(
+        static_thread_pool* pool, _static_thread_pool::clock_type::time_point deadline) noexcept
+      : timer_operation{invoke_impl, deadline}, pool_{pool}, continuation_{nullptr}
+    {
+    }
+
+    static void invoke_impl(void* owner, detail::operation_base* base);
+
+    static_thread_pool*     pool_;
+    std::coroutine_handle<> continuation_;
+  };
+
   template <typename Allocator, typename Function>
   struct thread_pool_operation : public detail::operation_base {
 
@@ -81,9 +375,48 @@ class static_thread_pool
 
 public:
 
+  using clock_type = _static_thread_pool::clock_type;
+
+  enum class scheduling_mode {
+    // every worker pulls from one shared queue, operations start in the order they were queued
+    shared_queue,
+    // Every worker owns a deque, idle workers steal from each other. A worker runs the newest
+    // operation of its own deque first, so operations don't start in the order they were
+    // queued, not even ones posted one after another from the same thread.
+    work_stealing
+  };
+
+  enum class thread_placement {
+    // leave it to the OS scheduler
+    none,
+    // restrict every worker to options::cpus
+    cpu_set,
+    // pin every worker to its own physical core, wrapping around
+    spread_cores,
+    // pin every worker to a NUMA node, round robin
+    spread_nodes
+  };
+
+  struct options {
+    scheduling_mode mode = scheduling_mode::shared_queue;
+    // Placement is best effort, workers run unpinned where the topology can't be read. Workers
+    // that know their NUMA node prefer to steal from and wake up workers on the same node.
+    thread_placement placement = thread_placement::none;
+    // The cpus to place workers on, every cpu the process may run on when empty
+    std::vector<int> cpus = {};
+    // Most operations a worker claims from the shared queue per lock acquisition, it never
+    // claims more than its fair share of the outstanding work
+    std::size_t batch_size = 1;
+    // How many times an idle worker looks for new work before it parks, a few thousand
+    // iterations hide most of the wake up latency at the cost of burning cpu while idle
+    std::size_t spin_count = 0;
+  };
+
   static_thread_pool() : static_thread_pool(std::thread::hardware_concurrency()) {}
 
-  explicit static_thread_pool(std::size_t n_threads);
+  explicit static_thread_pool(std::size_t n_threads) : static_thread_pool(n_threads, options{}) {}
+
+  static_thread_pool(std::size_t n_threads, options const& opts);
 
   static_thread_pool(static_thread_pool&&) = delete;
 
@@ -93,6 +426,23 @@ public:
 
   schedule_coro_operation schedule() noexcept { return {this}; }
 
+  /*
+   * Resumes the awaiting coroutine on the pool once the deadline has passed. Deadlines are
+   * rounded up to the next millisecond, a single timer thread per pool started by the first
+   * timer queues the due ones.
+   * */
+  schedule_timer_operation schedule_at(clock_type::time_point deadline) noexcept
+  {
+    return {this, deadline};
+  }
+
+  schedule_timer_operation schedule_after(clock_type::duration delay) noexcept
+  {
+    return {this, _static_thread_pool::deadline_after(delay)};
+  }
+
+  static_thread_pool_scheduler get_scheduler() noexcept { return {this}; }
+
   void attach();
 
   void stop();
@@ -104,9 +454,9 @@ public:
   template <typename Function>
   void post(Function&& function)
   {
-    auto allocator = get_allocator(function);
+    auto allocator = operation_allocator(function);
     auto operation = detail::allocation_utility::make_operation<
-        thread_pool_operation<allocator_t<Function>, std::remove_cvref_t<Function>>>(
+        thread_pool_operation<decltype(allocator), std::remove_cvref_t<Function>>>(
         allocator, std::forward<Function>(function));
     enqueue_operation(std::move(operation));
   }
@@ -114,9 +464,9 @@ public:
   template <typename Function>
   void defer(Function&& function)
   {
-    auto allocator = get_allocator(function);
+    auto allocator = operation_allocator(function);
     auto operation = detail::allocation_utility::make_operation<
-        thread_pool_operation<allocator_t<Function>, std::remove_cvref_t<Function>>>(
+        thread_pool_operation<decltype(allocator), std::remove_cvref_t<Function>>>(
         allocator, std::forward<Function>(function));
     if (running_in_this_thread())
       enqueue_continuation(std::move(operation));
@@ -124,25 +474,186 @@ public:
       enqueue_operation(std::move(operation));
   }
 
+  /*
+   * Posts function(0), function(1), ... function(count - 1). Every operation gets its own copy
+   * of function, they are all queued at once and up to count parked workers are woken up.
+   * */
+  template <typename Function>
+    requires std::copy_constructible<std::remove_cvref_t<Function>> &&
+        std::invocable<std::remove_cvref_t<Function>&, std::size_t>
+  void bulk_post(std::size_t count, Function&& function)
+  {
+    auto allocator = operation_allocator(function);
+
+    detail::operation_queue queue;
+    for (std::size_t i = 0; i < count; ++i) {
+      auto fn = [function, i]() mutable { function(i); };
+      queue.enqueue(detail::allocation_utility::make_operation<
+                    thread_pool_operation<decltype(allocator), decltype(fn)>>(
+          allocator, std::move(fn)));
+    }
+    enqueue_operations(std::move(queue), count);
+  }
+
+  /*
+   * Posts function(value) for a copy of every value in range, see above.
+   * */
+  template <std::ranges::input_range Range, typename Function>
+    requires std::copy_constructible<std::remove_cvref_t<Function>> &&
+        std::invocable<std::remove_cvref_t<Function>&, std::ranges::range_value_t<Range>&>
+  void bulk_post(Range&& range, Function&& function)
+  {
+    auto allocator = operation_allocator(function);
+
+    detail::operation_queue queue;
+    std::size_t             count = 0;
+    for (auto&& value : range) {
+      auto fn = [function, value = std::ranges::range_value_t<Range>(value)]() mutable {
+        function(value);
+      };
+      queue.enqueue(detail::allocation_utility::make_operation<
+                    thread_pool_operation<decltype(allocator), decltype(fn)>>(
+          allocator, std::move(fn)));
+      ++count;
+    }
+    enqueue_operations(std::move(queue), count);
+  }
+
 private:
 
+  /*
+   * Operations that would go through std::allocator use the thread caching allocator instead,
+   * so posting small callables doesn't hit malloc once the caches are warm.
+   * */
+  template <typename Function>
+  static auto operation_allocator(Function const& function) noexcept
+  {
+    auto allocator = get_allocator(function);
+    if constexpr (std::same_as<decltype(allocator), std::allocator<void>>)
+      return thread_caching_allocator<>{};
+    else
+      return allocator;
+  }
+
+  struct thread_storage;
+
+  struct worker;
+
+  struct timer_service;
+
+  bool is_running() const noexcept;
+
+  void attach_worker(int node);
+
+  worker* claim_worker(int node) noexcept;
+
+  /*
+   * The NUMA node the calling thread runs on, -1 when unknown or placement is none
+   * */
+  int current_node() const noexcept;
+
+  /*
+   * Hands back the next operation for the calling worker, blocking until one is available.
+   * Returns nullptr once the pool is done.
+   * */
+  detail::operation_ptr next_operation(thread_storage& storage);
+
+  detail::operation_ptr next_stolen_operation(thread_storage& storage);
+
+  /*
+   * pre-condition: lock holds mut_
+   * */
+  detail::operation_ptr take_queued(
+      thread_storage& storage, std::unique_lock<detail::fast_mutex>& lock);
+
+  bool has_work() const noexcept;
+
+  /*
+   * Spins for up to options::spin_count iterations or until there might be something to do.
+   * */
+  void spin_for_work() const noexcept;
+
+  /*
+   * Takes the calling thread back off the idle list, returns false if a producer got to it
+   * first, in which case an unpark is on its way.
+   * */
+  bool remove_idle(thread_storage& storage) noexcept;
+
+  void notify_idle(std::size_t count = 1) noexcept;
+
+  void notify_all() noexcept;
+
   void enqueue_operation(detail::operation_ptr operation) noexcept;
 
+  void enqueue_operations(detail::operation_queue&& operations, std::size_t count) noexcept;
+
   /*
    * pre-condition: running_in_this_thread()
    * */
   void enqueue_continuation(detail::operation_ptr operation) noexcept;
 
+  /*
+   * Queues operation once its deadline has passed, right away if it already has. A pending
+   * timer counts as work, wait() doesn't return before it ran.
+   * */
+  void add_timer(timer_operation& operation) noexcept;
+
+  // queues operation right away, false if it isn't waiting for its deadline
+  bool cancel_timer(timer_operation& operation) noexcept;
+
+  // the timer thread
+  void run_timers(timer_service& timers);
+
+  // joins the timer thread, the timers still pending complete with set_stopped
+  void stop_timers() noexcept;
+
+  options            options_;
+  std::size_t        thread_count_;
+  std::vector<int>   cpu_nodes_;
   std::atomic_bool   running_;
   std::atomic_size_t work_count_;
+  std::atomic_size_t idle_count_;
+
+  // producers never lock, consumers hold mut_
+  detail::mpsc_operation_queue main_operation_queue_;
 
-  detail::operation_queue main_operation_queue_;
+  // work_stealing mode only
+  std::vector<std::unique_ptr<worker>> workers_;
+
+  detail::fast_mutex mut_;
+
+  // parked threads, most recently parked first
+  detail::fast_mutex idle_mut_;
+  thread_storage*    idle_list_;
 
-  std::mutex               mut_;
-  std::condition_variable  cv_;
   std::vector<std::thread> threads_;
+
+  // guards timers_, which is created along with the timer thread by the first timer
+  detail::fast_mutex             timer_mut_;
+  std::unique_ptr<timer_service> timers_;
 };
 
+namespace _static_thread_pool
+{
+
+template <execution::receiver_of R>
+void op_state<R>::start() noexcept
+{
+  auto op = detail::operation_ptr{this};
+  if (pool_->running_in_this_thread())
+    pool_->enqueue_continuation(std::move(op));
+  else
+    pool_->enqueue_operation(std::move(op));
+}
+
+template <execution::receiver_of R>
+void timer_op_state<R>::start() noexcept
+{
+  pool_->add_timer(*this);
+}
+
+}  // namespace _static_thread_pool
+
 }  // namespace iol
 
 #endif  // IOL_STATIC_THREAD_POOL_HPP
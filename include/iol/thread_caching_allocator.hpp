@@ -0,0 +1,89 @@
+#ifndef IOL_THREAD_CACHING_ALLOCATOR_HPP
+#define IOL_THREAD_CACHING_ALLOCATOR_HPP
+
+#include <iol/detail/config.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace iol
+{
+
+namespace detail::thread_caching
+{
+
+inline constexpr std::size_t max_size = 4096;
+
+inline constexpr std::size_t alignment = alignof(std::max_align_t);
+
+/*
+ * pre-condition: size <= max_size
+ * */
+void* allocate(std::size_t size);
+
+/*
+ * pre-condition: p was returned by allocate, on any thread
+ * */
+void deallocate(void* p) noexcept;
+
+}  // namespace detail::thread_caching
+
+/*
+ * Every thread carves its allocations out of its own 64KiB chunks, one size class per chunk,
+ * and keeps a free list per size class, so allocating and freeing on the same thread never
+ * synchronizes. Memory freed on another thread is handed back to its owner in batches and
+ * picked up when the owner's free list runs dry.
+ *
+ * Chunks are only released once their thread has exited and every allocation made from them
+ * is freed. Allocations above 4KiB or over-aligned types go to std::allocator.
+ * */
+template <typename T = void>
+class thread_caching_allocator
+{
+
+public:
+
+  using value_type = T;
+
+  constexpr thread_caching_allocator() noexcept = default;
+
+  template <typename U>
+  constexpr thread_caching_allocator(thread_caching_allocator<U> const&) noexcept
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    if (is_cached(n))
+      return static_cast<T*>(detail::thread_caching::allocate(n * sizeof(T)));
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept
+  {
+    if (is_cached(n))
+      detail::thread_caching::deallocate(p);
+    else
+      std::allocator<T>{}.deallocate(p, n);
+  }
+
+  template <typename U>
+  friend constexpr bool operator==(
+      thread_caching_allocator const&, thread_caching_allocator<U> const&) noexcept
+  {
+    return true;
+  }
+
+private:
+
+  static constexpr bool is_cached(std::size_t n) noexcept
+  {
+    return alignof(T) <= detail::thread_caching::alignment &&
+        n <= detail::thread_caching::max_size / sizeof(T);
+  }
+};
+
+}  // namespace iol
+
+#endif  // IOL_THREAD_CACHING_ALLOCATOR_HPP
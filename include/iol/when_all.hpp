@@ -0,0 +1,194 @@
+#ifndef IOL_WHEN_ALL_HPP
+#define IOL_WHEN_ALL_HPP
+
+#include <iol/awaitable.hpp>
+#include <iol/detail/config.hpp>
+
+//
+
+#include <coroutine>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace iol
+{
+
+namespace detail
+{
+
+struct awaitable_access {
+
+  template <typename T>
+  static std::coroutine_handle<awaitable_promise<T>> handle(awaitable<T> const& a) noexcept
+  {
+    return a.handle_;
+  }
+};
+
+template <typename T>
+using when_all_result_t = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+/*
+ * Counts the not yet finished awaitables, pre-condition: none of them has been awaited
+ * */
+template <typename T>
+std::size_t when_all_pending(awaitable<T> const& a) noexcept
+{
+  return a.is_ready() ? 0 : 1;
+}
+
+template <typename T>
+void when_all_start(awaitable<T> const& a, awaitable_countdown& countdown)
+{
+  if (a.is_ready())
+    return;
+  auto handle = awaitable_access::handle(a);
+  handle.promise().set_countdown(&countdown);
+  handle.resume();
+}
+
+template <typename T>
+when_all_result_t<T> when_all_get(awaitable<T>& a)
+{
+  auto& promise = awaitable_access::handle(a).promise();
+  if constexpr (std::is_void_v<T>) {
+    promise.get_value();
+    return {};
+  } else {
+    return std::move(promise).get_value();
+  }
+}
+
+template <typename Tasks, typename F>
+void for_each_task(Tasks& tasks, F&& f)
+{
+  if constexpr (requires { std::tuple_size<std::remove_const_t<Tasks>>::value; })
+    std::apply([&](auto&... task) { (f(task), ...); }, tasks);
+  else
+    for (auto& task : tasks)
+      f(task);
+}
+
+/*
+ * Starts every awaitable right away on the awaiting thread and resumes the awaiting coroutine
+ * from whichever finishes last. The awaiter itself holds the countdown, nothing is allocated.
+ * */
+template <typename Tasks>
+class when_all_ready_awaiter
+{
+
+public:
+
+  explicit when_all_ready_awaiter(Tasks&& tasks) : tasks_{std::move(tasks)} {}
+
+  // pre-condition: other hasn't been awaited
+  when_all_ready_awaiter(when_all_ready_awaiter&& other) : tasks_{std::move(other.tasks_)} {}
+
+  bool await_ready() const noexcept { return pending() == 0; }
+
+  bool await_suspend(std::coroutine_handle<> continuation)
+  {
+    countdown_.continuation = continuation;
+    countdown_.count.store(pending() + 1, std::memory_order_relaxed);
+    for_each_task(tasks_, [this](auto& task) { when_all_start(task, countdown_); });
+    return !countdown_.arrive();
+  }
+
+  Tasks await_resume() noexcept { return std::move(tasks_); }
+
+protected:
+
+  std::size_t pending() const noexcept
+  {
+    std::size_t count = 0;
+    for_each_task(tasks_, [&](auto const& task) { count += when_all_pending(task); });
+    return count;
+  }
+
+  awaitable_countdown countdown_;
+  Tasks               tasks_;
+};
+
+template <typename Tasks>
+class when_all_awaiter : public when_all_ready_awaiter<Tasks>
+{
+
+public:
+
+  using when_all_ready_awaiter<Tasks>::when_all_ready_awaiter;
+
+  decltype(auto) await_resume()
+  {
+    auto& tasks = this->tasks_;
+    if constexpr (requires { std::tuple_size<Tasks>::value; }) {
+      return std::apply(
+          [](auto&... task) {
+            // braces keep the order, the first exception wins
+            return std::tuple<decltype(when_all_get(task))...>{when_all_get(task)...};
+          },
+          tasks);
+    } else {
+      using value_type = typename Tasks::value_type;
+      using result_type = decltype(when_all_get(std::declval<value_type&>()));
+      if constexpr (std::is_same_v<result_type, std::monostate>) {
+        for (auto& task : tasks)
+          when_all_get(task);
+      } else {
+        std::vector<result_type> results;
+        results.reserve(tasks.size());
+        for (auto& task : tasks)
+          results.push_back(when_all_get(task));
+        return results;
+      }
+    }
+  }
+};
+
+}  // namespace detail
+
+/*
+ * co_await when_all_ready(a, b, ...) waits for all of them to finish and hands them back, the
+ * results (or exceptions) are then read by awaiting each one.
+ *
+ * pre-condition: none of the awaitables has been awaited
+ * */
+template <typename... Ts>
+auto when_all_ready(awaitable<Ts>... tasks)
+{
+  return detail::when_all_ready_awaiter<std::tuple<awaitable<Ts>...>>{
+      std::tuple<awaitable<Ts>...>{std::move(tasks)...}};
+}
+
+template <typename T>
+auto when_all_ready(std::vector<awaitable<T>> tasks)
+{
+  return detail::when_all_ready_awaiter<std::vector<awaitable<T>>>{std::move(tasks)};
+}
+
+/*
+ * co_await when_all(a, b, ...) gives a tuple of the results, void results become
+ * std::monostate. Awaiting a vector gives a vector of the results, or void. If any of them
+ * threw, the first exception in argument order is rethrown once all have finished.
+ *
+ * pre-condition: none of the awaitables has been awaited
+ * */
+template <typename... Ts>
+auto when_all(awaitable<Ts>... tasks)
+{
+  return detail::when_all_awaiter<std::tuple<awaitable<Ts>...>>{
+      std::tuple<awaitable<Ts>...>{std::move(tasks)...}};
+}
+
+template <typename T>
+auto when_all(std::vector<awaitable<T>> tasks)
+{
+  return detail::when_all_awaiter<std::vector<awaitable<T>>>{std::move(tasks)};
+}
+
+}  // namespace iol
+
+#endif  // IOL_WHEN_ALL_HPP
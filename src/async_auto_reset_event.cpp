@@ -0,0 +1,100 @@
+#include <iol/async_auto_reset_event.hpp>
+
+#include <algorithm>
+
+namespace iol
+{
+
+bool async_auto_reset_event_operation::await_suspend(
+    std::coroutine_handle<> continuation) noexcept
+{
+  continuation_ = continuation;
+
+  auto state = event_.state_.load(std::memory_order_acquire);
+  while (async_auto_reset_event::set_count(state) >
+         async_auto_reset_event::waiter_count(state)) {
+    if (event_.state_.compare_exchange_weak(
+            state, state - async_auto_reset_event::set_increment, std::memory_order_acquire,
+            std::memory_order_acquire))
+      return false;
+  }
+
+  // queued before it is counted, whoever pairs it up is sure to find it
+  auto* head = event_.new_waiters_.load(std::memory_order_relaxed);
+  do {
+    next_ = head;
+  } while (!event_.new_waiters_.compare_exchange_weak(
+      head, this, std::memory_order_release, std::memory_order_relaxed));
+
+  state = event_.state_.fetch_add(
+      async_auto_reset_event::waiter_increment, std::memory_order_acq_rel);
+  if (async_auto_reset_event::set_count(state) != 0 &&
+      async_auto_reset_event::waiter_count(state) == 0)
+    event_.resume_waiters(state + async_auto_reset_event::waiter_increment);
+
+  // this may have been resumed already
+  return true;
+}
+
+void async_auto_reset_event::set() noexcept
+{
+  auto state = state_.load(std::memory_order_relaxed);
+  do {
+    if (set_count(state) > waiter_count(state))
+      return;
+  } while (!state_.compare_exchange_weak(
+      state, state + set_increment, std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  if (set_count(state) == 0 && waiter_count(state) != 0)
+    resume_waiters(state + set_increment);
+}
+
+void async_auto_reset_event::reset() noexcept
+{
+  auto state = state_.load(std::memory_order_relaxed);
+  while (set_count(state) > waiter_count(state)) {
+    if (state_.compare_exchange_weak(
+            state, state - set_increment, std::memory_order_relaxed, std::memory_order_relaxed))
+      return;
+  }
+}
+
+void async_auto_reset_event::resume_waiters(std::uint64_t state) noexcept
+{
+  async_auto_reset_event_operation*  to_resume = nullptr;
+  async_auto_reset_event_operation** tail = &to_resume;
+
+  std::uint64_t count = std::min(set_count(state), waiter_count(state));
+  do {
+    for (auto n = count; n; --n) {
+      if (!waiters_) {
+        // new waiters were pushed newest first
+        auto* waiter = new_waiters_.exchange(nullptr, std::memory_order_acquire);
+        IOL_ASSERT(waiter);
+        do {
+          auto* next = waiter->next_;
+          waiter->next_ = waiters_;
+          waiters_ = waiter;
+          waiter = next;
+        } while (waiter);
+      }
+      auto* waiter = waiters_;
+      waiters_ = waiter->next_;
+      waiter->next_ = nullptr;
+      *tail = waiter;
+      tail = &waiter->next_;
+    }
+
+    auto const delta = count * set_increment + count * waiter_increment;
+    state = state_.fetch_sub(delta, std::memory_order_acq_rel) - delta;
+    count = std::min(set_count(state), waiter_count(state));
+  } while (count);
+
+  while (to_resume) {
+    auto* next = to_resume->next_;
+    to_resume->continuation_.resume();
+    to_resume = next;
+  }
+}
+
+}  // namespace iol
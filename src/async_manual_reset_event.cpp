@@ -0,0 +1,43 @@
+#include <iol/async_manual_reset_event.hpp>
+
+namespace iol
+{
+
+bool async_manual_reset_event_operation::await_suspend(
+    std::coroutine_handle<> continuation) noexcept
+{
+  continuation_ = continuation;
+
+  void const* const set_state = &event_;
+  auto              state = event_.state_.load(std::memory_order_acquire);
+  do {
+    if (state == set_state)
+      return false;
+    next_ = static_cast<async_manual_reset_event_operation*>(state);
+  } while (!event_.state_.compare_exchange_weak(
+      state, this, std::memory_order_release, std::memory_order_acquire));
+  return true;
+}
+
+void async_manual_reset_event::set() noexcept
+{
+  auto* state = state_.exchange(this, std::memory_order_acq_rel);
+  if (state == this)
+    return;
+
+  auto* waiter = static_cast<async_manual_reset_event_operation*>(state);
+  while (waiter) {
+    // the waiter lives in the frame it resumes
+    auto* next = waiter->next_;
+    waiter->continuation_.resume();
+    waiter = next;
+  }
+}
+
+void async_manual_reset_event::reset() noexcept
+{
+  void* state = this;
+  state_.compare_exchange_strong(state, nullptr, std::memory_order_relaxed);
+}
+
+}  // namespace iol
@@ -0,0 +1,67 @@
+#include <iol/async_mutex.hpp>
+
+namespace iol
+{
+
+bool async_mutex_lock_operation::await_suspend(std::coroutine_handle<> continuation) noexcept
+{
+  continuation_ = continuation;
+
+  auto state = mutex_.state_.load(std::memory_order_relaxed);
+  while (true) {
+    if (state == async_mutex::not_locked) {
+      if (mutex_.state_.compare_exchange_weak(
+              state, async_mutex::locked_no_waiters, std::memory_order_acquire,
+              std::memory_order_relaxed))
+        return false;
+    } else {
+      next_ = reinterpret_cast<async_mutex_lock_operation*>(state);
+      if (mutex_.state_.compare_exchange_weak(
+              state, reinterpret_cast<std::uintptr_t>(this), std::memory_order_release,
+              std::memory_order_relaxed))
+        return true;
+    }
+  }
+}
+
+void async_mutex_lock_operation::resume() noexcept
+{
+  if (defer_) {
+    try {
+      defer_(executor_, continuation_);
+      return;
+    } catch (...) {
+      // fall back to resuming inline
+    }
+  }
+  continuation_.resume();
+}
+
+void async_mutex::unlock()
+{
+  IOL_ASSERT(state_.load(std::memory_order_relaxed) != not_locked);
+
+  auto* head = waiters_;
+  if (!head) {
+    auto state = locked_no_waiters;
+    if (state_.compare_exchange_strong(
+            state, not_locked, std::memory_order_release, std::memory_order_relaxed))
+      return;
+
+    // take everybody who queued up so far, they were pushed newest first
+    state = state_.exchange(locked_no_waiters, std::memory_order_acquire);
+    auto* waiter = reinterpret_cast<async_mutex_lock_operation*>(state);
+    do {
+      auto* next = waiter->next_;
+      waiter->next_ = head;
+      head = waiter;
+      waiter = next;
+    } while (waiter);
+  }
+
+  // ownership passes to the waiter, the mutex stays locked
+  waiters_ = head->next_;
+  head->resume();
+}
+
+}  // namespace iol
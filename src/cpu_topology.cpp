@@ -0,0 +1,108 @@
+#include <iol/detail/cpu_topology.hpp>
+
+#if defined(linux)
+
+#include <sched.h>
+
+#include <charconv>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace
+{
+
+namespace local
+{
+
+int read_int(std::filesystem::path const& path, int fallback)
+{
+  std::ifstream in{path};
+  int           value;
+  return (in >> value) ? value : fallback;
+}
+
+// the nodeN link in the cpu's directory, node 0 if there is none or it doesn't parse
+int node_of(std::filesystem::path const& cpu_dir)
+{
+  std::error_code ec;
+  for (std::filesystem::directory_iterator it{cpu_dir, ec}, end; !ec && it != end;
+       it.increment(ec)) {
+    auto const name = it->path().filename().string();
+    if (name.size() <= 4 || !name.starts_with("node"))
+      continue;
+    auto const* const last = name.data() + name.size();
+    int               node;
+    auto const [ptr, error] = std::from_chars(name.data() + 4, last, node);
+    if (error == std::errc{} && ptr == last)
+      return node;
+  }
+  return 0;
+}
+
+}  // namespace local
+
+}  // namespace
+
+#endif
+
+namespace iol::detail
+{
+
+#if defined(linux)
+
+std::vector<cpu_info> available_cpus()
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (sched_getaffinity(0, sizeof(set), &set) != 0)
+    return {};
+
+  std::vector<cpu_info> cpus;
+  for (int id = 0; id < CPU_SETSIZE; ++id) {
+    if (!CPU_ISSET(id, &set))
+      continue;
+    auto const dir =
+        std::filesystem::path{"/sys/devices/system/cpu"} / ("cpu" + std::to_string(id));
+    auto const package = local::read_int(dir / "topology" / "physical_package_id", 0);
+    auto const core = local::read_int(dir / "topology" / "core_id", id);
+    cpus.push_back({id, (package << 16) | core, local::node_of(dir)});
+  }
+  return cpus;
+}
+
+bool pin_this_thread(std::vector<int> const& cpus) noexcept
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus)
+    if (cpu >= 0 && cpu < CPU_SETSIZE)
+      CPU_SET(cpu, &set);
+  return CPU_COUNT(&set) && sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+int current_cpu() noexcept
+{
+  return sched_getcpu();
+}
+
+#else
+
+std::vector<cpu_info> available_cpus()
+{
+  return {};
+}
+
+bool pin_this_thread(std::vector<int> const&) noexcept
+{
+  return false;
+}
+
+int current_cpu() noexcept
+{
+  return -1;
+}
+
+#endif
+
+}  // namespace iol::detail
@@ -1,5 +1,41 @@
 #include <iol/execution/run_loop.hpp>
 
+#if defined(linux)
+
+#include <linux/futex.h> /* Definition of FUTEX_* constants */
+#include <sys/syscall.h> /* Definition of SYS_* constants */
+#include <unistd.h>
+
+#include <bit>
+
+namespace
+{
+
+namespace local
+{
+
+inline long futex(
+    uint32_t* uaddr, int futex_op, uint32_t val, timespec const* timeout, uint32_t* uaddr2,
+    uint32_t val3)
+{
+  return syscall(SYS_futex, uaddr, futex_op, val, timeout, uaddr2, val3);
+}
+
+// the half of the head word that holds the sleeping flag, the futex compares 32 bits
+inline std::uint32_t* futex_word(std::atomic<std::uintptr_t>& head) noexcept
+{
+  static_assert(sizeof(std::atomic<std::uintptr_t>) == sizeof(std::uintptr_t));
+  constexpr auto low_half = std::endian::native == std::endian::little ? 0 : 1;
+  return reinterpret_cast<std::uint32_t*>(&head) + (sizeof(std::uintptr_t) > 4 ? low_half : 0);
+}
+
+}  // namespace local
+
+}  // namespace
+
+#endif
+
+#include <exception>
 #include <utility>
 
 namespace iol::execution
@@ -9,12 +45,22 @@ namespace _run_loop
 {
 
 run_loop::run_loop() noexcept
-  : head_(nullptr), tail_(&head_), n_work_{0}, state_{state_t::running}, mut_{}, cv_{}
+  : head_{empty},
+    front_{nullptr},
+    back_{nullptr},
+    finishing_{false},
+    finish_requested_{false},
+    finish_marker_{[](opstate_base*) noexcept {}, nullptr}
 {}
 
 run_loop::~run_loop()
 {
-  [[unlikely]] if (n_work_ != 0 || state_ == state_t::running) std::terminate();
+  auto const head = head_.load(std::memory_order_acquire);
+  // finish() without run() leaves just the marker behind
+  auto const only_marker = head == reinterpret_cast<std::uintptr_t>(&finish_marker_) &&
+                           !finish_marker_.next_;
+  [[unlikely]] if (!finish_requested_.load(std::memory_order_relaxed) || front_ ||
+                   (head > sleeping && !only_marker)) std::terminate();
 }
 
 void run_loop::run()
@@ -23,41 +69,176 @@ void run_loop::run()
     op->execute(op);
 }
 
-void run_loop::finish()
+bool run_loop::run_one()
+{
+  auto* op = pop_front();
+  if (op)
+    op->execute(op);
+  return op;
+}
+
+std::size_t run_loop::poll()
 {
-  {
-    std::scoped_lock<std::mutex> lock{mut_};
-    state_ = state_t::finishing;
+  take_pushed();
+  auto* batch = std::exchange(front_, nullptr);
+
+  std::size_t count = 0;
+  while (batch) {
+    auto* op = std::exchange(batch, batch->next_);
+    if (op == &finish_marker_) {
+      finishing_ = true;
+      continue;
+    }
+    ++count;
+    op->execute(op);
   }
-  cv_.notify_all();
+  return count;
+}
+
+bool run_loop::poll_one()
+{
+  auto* op = try_pop_front();
+  if (op)
+    op->execute(op);
+  return op;
+}
+
+std::size_t run_loop::run_until_idle()
+{
+  std::size_t total = 0;
+  while (auto const count = poll())
+    total += count;
+  return total;
+}
+
+void run_loop::finish()
+{
+  if (!finish_requested_.exchange(true, std::memory_order_relaxed))
+    push_back(&finish_marker_);
 }
 
 void run_loop::push_back(opstate_base* op)
 {
-  {
-    std::scoped_lock<std::mutex> lock{mut_};
-    ++n_work_;
-    *tail_ = op;
-    tail_ = &op->next_;
+  auto head = head_.load(std::memory_order_relaxed);
+  while (true) {
+    if (head == sleeping) {
+      if (wake(op))
+        return;
+      head = head_.load(std::memory_order_relaxed);
+      continue;
+    }
+    op->next_ = reinterpret_cast<opstate_base*>(head);
+    if (head_.compare_exchange_weak(
+            head, reinterpret_cast<std::uintptr_t>(op), std::memory_order_release,
+            std::memory_order_relaxed))
+      return;
   }
-  cv_.notify_one();
 }
 
 opstate_base* run_loop::pop_front()
 {
-  std::unique_lock<std::mutex> lock{mut_};
+  while (true) {
+    if (auto* op = try_pop_front())
+      return op;
+    if (finishing_)
+      return nullptr;
+    sleep();
+  }
+}
+
+opstate_base* run_loop::try_pop_front() noexcept
+{
+  while (front_ || take_pushed()) {
+    auto* op = std::exchange(front_, front_->next_);
+    if (op != &finish_marker_)
+      return op;
+    finishing_ = true;
+  }
+  return nullptr;
+}
+
+bool run_loop::take_pushed() noexcept
+{
+  auto head = head_.load(std::memory_order_relaxed);
+  if (head <= sleeping)
+    return false;
+
+  // pushed newest first, whatever poll_one() or run_one() left in front_ is older
+  auto* op = reinterpret_cast<opstate_base*>(head_.exchange(empty, std::memory_order_acquire));
+  auto* const   back = op;
+  opstate_base* batch = nullptr;
+  do {
+    auto* next = op->next_;
+    op->next_ = batch;
+    batch = op;
+    op = next;
+  } while (op);
+
+  if (front_)
+    back_->next_ = batch;
+  else
+    front_ = batch;
+  back_ = back;
+  return true;
+}
+
+#if defined(linux)
 
-  cv_.wait(lock, [&, this] { return (n_work_ > 0 || state_ == state_t::finishing); });
-  // If n_work is 0 we know the state is also finishing
-  if (n_work_ == 0)
-    return nullptr;
+void run_loop::sleep()
+{
+  auto head = empty;
+  if (!head_.compare_exchange_strong(
+          head, sleeping, std::memory_order_relaxed, std::memory_order_relaxed))
+    return;
+  // any push replaces the flag, the futex returns right away if one got in first
+  while (head_.load(std::memory_order_relaxed) == sleeping)
+    local::futex(
+        local::futex_word(head_), FUTEX_WAIT_PRIVATE, sleeping, nullptr, nullptr, 0);
+}
 
-  --n_work_;
-  auto head = std::exchange(head_, head_->next_);
-  tail_ = head_ ? tail_ : &head_;
-  return head;
+bool run_loop::wake(opstate_base* op)
+{
+  op->next_ = nullptr;
+  auto head = sleeping;
+  if (!head_.compare_exchange_strong(
+          head, reinterpret_cast<std::uintptr_t>(op), std::memory_order_release,
+          std::memory_order_relaxed))
+    return false;
+  // a loop that woke up spuriously may be gone already, waking a stale address is harmless
+  local::futex(local::futex_word(head_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+  return true;
 }
 
+#else
+
+void run_loop::sleep()
+{
+  auto head = empty;
+  if (!head_.compare_exchange_strong(
+          head, sleeping, std::memory_order_relaxed, std::memory_order_relaxed))
+    return;
+  std::unique_lock<std::mutex> lock{mut_};
+  cv_.wait(lock, [this] { return head_.load(std::memory_order_relaxed) != sleeping; });
+}
+
+bool run_loop::wake(opstate_base* op)
+{
+  // the sleeping loop only looks at head_ with the lock held, so it can't see op and go away
+  // before notify_one() is done. Only a sleeping loop waits for the lock, one that is awake
+  // could take op and be destroyed while this still holds it.
+  std::scoped_lock<std::mutex> lock{mut_};
+  op->next_ = nullptr;
+  auto head = sleeping;
+  if (!head_.compare_exchange_strong(
+          head, reinterpret_cast<std::uintptr_t>(op), std::memory_order_release,
+          std::memory_order_relaxed))
+    return false;
+  cv_.notify_one();
+  return true;
+}
+
+#endif
+
 }  // namespace _run_loop
 
 }  // namespace iol::execution
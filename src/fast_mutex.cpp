@@ -6,7 +6,12 @@
 #include <sys/syscall.h> /* Definition of SYS_* constants */
 #include <unistd.h>
 
-#include <numeric>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <thread>
 
 namespace
 {
@@ -29,28 +34,57 @@ inline std::uint32_t cmpxchg(
   return *ep;
 }
 
+constexpr std::uint32_t max_spins = 100;
+
+// with one cpu the holder can't make progress while we spin
+bool const can_spin = std::thread::hardware_concurrency() > 1;
+
 }  // namespace local
 
 }  // namespace
 
+#endif
+
 namespace iol::detail
 {
 
 #if defined(linux)
 
-fast_mutex::fast_mutex() noexcept : state_{0} {}
+fast_mutex::fast_mutex() noexcept : state_{0}, spins_{0} {}
 
 void fast_mutex::lock()
 {
-  auto old_state = local::cmpxchg(&state_, 0, 1);
-  if (old_state != 0) {
-    if (old_state != 2)
-      old_state = state_.exchange(2, std::memory_order_acq_rel);
-    while (old_state != 0) {
-      local::futex((std::uint32_t*)&state_, FUTEX_WAIT_PRIVATE, 2, 0, 0, 0);
-      old_state = state_.exchange(2, std::memory_order_acq_rel);
+  if (local::cmpxchg(&state_, 0, 1) != 0)
+    lock_slow();
+}
+
+void fast_mutex::lock_slow()
+{
+  if (local::can_spin) {
+    auto const average = spins_.load(std::memory_order_relaxed);
+    auto const limit = std::min(local::max_spins, average * 2 + 10);
+
+    std::uint32_t spins = 0;
+    bool          locked = false;
+    while (spins < limit && !locked) {
+      ++spins;
+      IOL_SPIN_PAUSE();
+      locked = state_.load(std::memory_order_relaxed) == 0 && local::cmpxchg(&state_, 0, 1) == 0;
     }
+
+    // moves the average an eighth of the way, spinning out pushes it up as well
+    auto const delta = static_cast<std::int32_t>(spins - average) / 8;
+    spins_.store(average + delta, std::memory_order_relaxed);
+    if (locked)
+      return;
   }
+  lock_contended();
+}
+
+void fast_mutex::lock_contended()
+{
+  while (state_.exchange(2, std::memory_order_acquire) != 0)
+    local::futex((std::uint32_t*)&state_, FUTEX_WAIT_PRIVATE, 2, 0, 0, 0);
 }
 
 bool fast_mutex::try_lock()
@@ -60,21 +94,114 @@ bool fast_mutex::try_lock()
 
 void fast_mutex::unlock()
 {
-
-  // We could either wake one up or wake up several?
-  // What to do...
-  constexpr auto waiters_to_wake_up = 1;
   if (state_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
-    [[maybe_unused]] auto n_awoken = local::futex(
-        (uint32_t*)&state_, FUTEX_WAKE_PRIVATE, waiters_to_wake_up, nullptr, nullptr, 0);
+    // was 2, the woken thread locks with 2 again so whoever is left gets woken in turn
+    state_.store(0, std::memory_order_release);
+    [[maybe_unused]] auto n_awoken =
+        local::futex((uint32_t*)&state_, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
     IOL_ASSERT(n_awoken != -1);
   }
 }
 
+fast_mutex::cond_var::cond_var() noexcept : seq_{0}, waiters_{0}, mutex_{nullptr} {}
+
+// waiters_ is raised while the waiter still holds the mutex, a notifier that changed the
+// condition under the mutex can't miss it
+void fast_mutex::cond_var::notify_one() noexcept
+{
+  if (!waiters_.load(std::memory_order_seq_cst))
+    return;
+  seq_.fetch_add(1, std::memory_order_acq_rel);
+  local::futex((uint32_t*)&seq_, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+
+void fast_mutex::cond_var::notify_all() noexcept
+{
+  if (!waiters_.load(std::memory_order_seq_cst))
+    return;
+  auto* mutex = mutex_.load(std::memory_order_relaxed);
+
+  auto seq = seq_.fetch_add(1, std::memory_order_acq_rel) + 1;
+  // the requeue count travels in the timeout argument
+  while (local::futex(
+             (uint32_t*)&seq_, FUTEX_CMP_REQUEUE_PRIVATE, 1,
+             reinterpret_cast<timespec const*>(std::uintptr_t{INT_MAX}),
+             (uint32_t*)&mutex->state_, seq) == -1 &&
+         errno == EAGAIN)
+    seq = seq_.load(std::memory_order_acquire);
+}
+
+void fast_mutex::cond_var::wait(scoped_lock& lock)
+{
+  IOL_ASSERT(lock.locked_);
+  auto& mutex = lock.mutex_;
+  mutex_.store(&mutex, std::memory_order_relaxed);
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+
+  auto const seq = seq_.load(std::memory_order_acquire);
+  mutex.unlock();
+  local::futex((uint32_t*)&seq_, FUTEX_WAIT_PRIVATE, seq, nullptr, nullptr, 0);
+  // this thread may have been requeued onto the mutex, others may still be
+  mutex.lock_contended();
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+std::cv_status fast_mutex::cond_var::wait_for(scoped_lock& lock, std::chrono::nanoseconds timeout)
+{
+  IOL_ASSERT(lock.locked_);
+  auto& mutex = lock.mutex_;
+  mutex_.store(&mutex, std::memory_order_relaxed);
+  waiters_.fetch_add(1, std::memory_order_seq_cst);
+
+  auto const seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  timespec const relative{
+      static_cast<std::time_t>(seconds.count()),
+      static_cast<long>((timeout - seconds).count())};
+
+  auto const seq = seq_.load(std::memory_order_acquire);
+  mutex.unlock();
+  auto const result =
+      local::futex((uint32_t*)&seq_, FUTEX_WAIT_PRIVATE, seq, &relative, nullptr, 0);
+  auto const status =
+      result == -1 && errno == ETIMEDOUT ? std::cv_status::timeout : std::cv_status::no_timeout;
+  mutex.lock_contended();
+  waiters_.fetch_sub(1, std::memory_order_relaxed);
+  return status;
+}
+
 #else
 
-#endif
+fast_mutex::fast_mutex() noexcept : mut_{} {}
 
-}  // namespace iol::detail
+void fast_mutex::lock() { mut_.lock(); }
+
+bool fast_mutex::try_lock() { return mut_.try_lock(); }
+
+void fast_mutex::unlock() { mut_.unlock(); }
+
+fast_mutex::cond_var::cond_var() noexcept : cv_{} {}
+
+void fast_mutex::cond_var::notify_one() noexcept { cv_.notify_one(); }
+
+void fast_mutex::cond_var::notify_all() noexcept { cv_.notify_all(); }
+
+void fast_mutex::cond_var::wait(scoped_lock& lock)
+{
+  IOL_ASSERT(lock.locked_);
+  std::unique_lock<std::mutex> adopted{lock.mutex_.mut_, std::adopt_lock};
+  cv_.wait(adopted);
+  adopted.release();
+}
+
+std::cv_status fast_mutex::cond_var::wait_for(scoped_lock& lock, std::chrono::nanoseconds timeout)
+{
+  IOL_ASSERT(lock.locked_);
+  std::unique_lock<std::mutex> adopted{lock.mutex_.mut_, std::adopt_lock};
+  auto const status = cv_.wait_for(adopted, timeout);
+  adopted.release();
+  return status;
+}
 
 #endif
+
+}  // namespace iol::detail
@@ -0,0 +1,119 @@
+#include <iol/detail/mpsc_operation_queue.hpp>
+
+#include <cstddef>
+#include <utility>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol::detail;
+
+inline operation_base* load_next(operation_base* op) noexcept
+{
+  return std::atomic_ref<operation_base*>{op->next}.load(std::memory_order_acquire);
+}
+
+inline void store_next(operation_base* op, operation_base* next) noexcept
+{
+  std::atomic_ref<operation_base*>{op->next}.store(next, std::memory_order_release);
+}
+
+}  // namespace local
+
+}  // namespace
+
+namespace iol::detail
+{
+
+mpsc_operation_queue::mpsc_operation_queue() noexcept
+  : back_{&stub_}, front_{&stub_}, stub_{nullptr, nullptr}
+{}
+
+mpsc_operation_queue::~mpsc_operation_queue()
+{
+  while (try_deque())
+    ;
+}
+
+void mpsc_operation_queue::enqueue(operation_ptr&& operation) noexcept
+{
+  auto* op = operation.release();
+  push(op, op);
+}
+
+void mpsc_operation_queue::enqueue(operation_queue&& queue) noexcept
+{
+  if (queue.empty())
+    return;
+  // tail_ points at the next member of the last queued operation
+  auto* last = reinterpret_cast<operation_base*>(
+      reinterpret_cast<char*>(queue.tail_) - offsetof(operation_base, next));
+  push(std::exchange(queue.head_, nullptr), last);
+  queue.tail_ = &queue.head_;
+}
+
+bool mpsc_operation_queue::empty() const noexcept
+{
+  return front_ == &stub_ && back_.load(std::memory_order_acquire) == &stub_;
+}
+
+bool mpsc_operation_queue::likely_empty() const noexcept
+{
+  return back_.load(std::memory_order_relaxed) == &stub_;
+}
+
+operation_ptr mpsc_operation_queue::try_deque() noexcept
+{
+  auto* front = front_;
+  auto* next = local::load_next(front);
+
+  if (front == &stub_) {
+    if (!next)
+      return nullptr;
+    front_ = front = next;
+    next = local::load_next(front);
+  }
+
+  if (next) {
+    front_ = next;
+    return operation_ptr{front};
+  }
+
+  // front is the last linked operation, a producer might be in the middle of linking the
+  // next one
+  if (front != back_.load(std::memory_order_acquire))
+    return nullptr;
+
+  push(&stub_, &stub_);
+
+  next = local::load_next(front);
+  if (next) {
+    front_ = next;
+    return operation_ptr{front};
+  }
+  return nullptr;
+}
+
+std::size_t mpsc_operation_queue::try_deque(operation_queue& queue, std::size_t max) noexcept
+{
+  std::size_t count = 0;
+  for (; count < max; ++count) {
+    auto op = try_deque();
+    if (!op)
+      break;
+    queue.enqueue(std::move(op));
+  }
+  return count;
+}
+
+void mpsc_operation_queue::push(operation_base* first, operation_base* last) noexcept
+{
+  last->next = nullptr;
+  auto* previous = back_.exchange(last, std::memory_order_acq_rel);
+  local::store_next(previous, first);
+}
+
+}  // namespace iol::detail
@@ -4,10 +4,10 @@
 namespace iol::detail
 {
 
-operation_queue::operation_queue() noexcept : head_{}, tail_{&head_} {};
+operation_queue::operation_queue() noexcept : head_{nullptr}, tail_{&head_} {};
 
 operation_queue::operation_queue(operation_queue&& other) noexcept
-  : head_{std::move(other.head_)}, tail_{head_ ? other.tail_ : &head_}
+  : head_{std::exchange(other.head_, nullptr)}, tail_{head_ ? other.tail_ : &head_}
 {
   other.tail_ = &other.head_;
 }
@@ -21,6 +21,12 @@ operation_queue& operation_queue::operator=(operation_queue&& other) noexcept
   return *this;
 }
 
+operation_queue::~operation_queue()
+{
+  while (!empty())
+    deque();
+}
+
 void operation_queue::swap(operation_queue& other) noexcept
 {
   using std::swap;
@@ -37,7 +43,8 @@ bool operation_queue::empty() const noexcept
 
 void operation_queue::enqueue(operation_ptr&& operation) noexcept
 {
-  *tail_ = std::move(operation);
+  *tail_ = operation.release();
+  (*tail_)->next = nullptr;
   tail_ = &((*tail_)->next);
 }
 
@@ -45,14 +52,14 @@ void operation_queue::enqueue(operation_queue&& queue) noexcept
 {
   if (queue.empty())
     return;
-  *tail_ = std::move(queue.head_);
+  *tail_ = std::exchange(queue.head_, nullptr);
   tail_ = std::exchange(queue.tail_, &queue.head_);
 }
 
 operation_ptr operation_queue::deque() noexcept
 {
   IOL_ASSERT(head_);
-  operation_ptr ret = std::exchange(head_, std::move(head_->next));
+  operation_ptr ret{std::exchange(head_, head_->next)};
   tail_ = head_ ? tail_ : &head_;
   return ret;
 }
@@ -0,0 +1,76 @@
+#include <iol/sequence_barrier.hpp>
+
+namespace iol
+{
+
+void sequence_barrier_operation::await_suspend(std::coroutine_handle<> continuation) noexcept
+{
+  continuation_ = continuation;
+
+  // once queued another thread may resume and destroy this operation
+  auto&      barrier = barrier_;
+  auto const target = target_;
+
+  auto* head = barrier.waiters_.load(std::memory_order_relaxed);
+  do {
+    next_ = head;
+  } while (!barrier.waiters_.compare_exchange_weak(
+      head, this, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+  // a publish that didn't see this waiter yet is visible here, whoever takes it off the queue
+  // resumes it
+  if (sequence_barrier::reached(barrier.last_published_.load(std::memory_order_seq_cst), target))
+    barrier.resume_published();
+}
+
+void sequence_barrier::publish(std::size_t sequence) noexcept
+{
+  last_published_.store(sequence, std::memory_order_seq_cst);
+  resume_published();
+}
+
+void sequence_barrier::resume_published() noexcept
+{
+  sequence_barrier_operation* to_resume = nullptr;
+
+  while (auto* waiter = waiters_.exchange(nullptr, std::memory_order_seq_cst)) {
+    auto const published = last_published_.load(std::memory_order_seq_cst);
+
+    sequence_barrier_operation* pending = nullptr;
+    sequence_barrier_operation* pending_tail = nullptr;
+    while (waiter) {
+      auto* next = waiter->next_;
+      if (!reached(published, waiter->target_)) {
+        waiter->next_ = pending;
+        pending = waiter;
+        if (!pending_tail)
+          pending_tail = waiter;
+      } else {
+        waiter->next_ = to_resume;
+        to_resume = waiter;
+      }
+      waiter = next;
+    }
+
+    if (!pending)
+      break;
+
+    auto* head = waiters_.load(std::memory_order_relaxed);
+    do {
+      pending_tail->next_ = head;
+    } while (!waiters_.compare_exchange_weak(
+        head, pending, std::memory_order_seq_cst, std::memory_order_relaxed));
+
+    // a publish since the exchange above may have found the queue empty
+    if (last_published_.load(std::memory_order_seq_cst) == published)
+      break;
+  }
+
+  while (to_resume) {
+    auto* next = to_resume->next_;
+    to_resume->continuation_.resume();
+    to_resume = next;
+  }
+}
+
+}  // namespace iol
@@ -21,6 +21,8 @@ inline long futex(
   return syscall(SYS_futex, uaddr, futex_op, val, timeout, uaddr2, val3);
 }
 
+enum : int { not_set = 0, set = 1, not_set_waiting = 2 };
+
 }  // namespace local
 
 }  // namespace
@@ -46,12 +48,13 @@ void simple_manual_reset_event::set()
   state_ = true;
   cv_.notify_all();
 #else
-  state_.store(1, std::memory_order_release);
-  [[maybe_unused]] auto n_awoken = local::futex(
-      (uint32_t*)&state_, FUTEX_WAKE_PRIVATE,
-      // How many to wake up
-      std::numeric_limits<int>::max(), nullptr, nullptr, 0);
-  IOL_ASSERT(n_awoken != -1);
+  if (state_.exchange(local::set, std::memory_order_release) == local::not_set_waiting) {
+    [[maybe_unused]] auto n_awoken = local::futex(
+        (uint32_t*)&state_, FUTEX_WAKE_PRIVATE,
+        // How many to wake up
+        std::numeric_limits<int>::max(), nullptr, nullptr, 0);
+    IOL_ASSERT(n_awoken != -1);
+  }
 #endif
 }
 
@@ -59,36 +62,43 @@ void simple_manual_reset_event::reset()
 {
 #if !defined(linux)
   std::scoped_lock<std::mutex> lock{mut_};
-  state_.store(true, std::memory_order_relaxed);
+  state_.store(false, std::memory_order_relaxed);
 #else
-  state_.store(0, std::memory_order_relaxed);
+  // leaves a sleeping waiter's mark alone
+  int state = local::set;
+  state_.compare_exchange_strong(state, local::not_set, std::memory_order_relaxed);
 #endif
 }
 
-void simple_manual_reset_event::wait() const
+void simple_manual_reset_event::wait(std::size_t spin_count) const
 {
+  for (; spin_count && !is_set(); --spin_count)
+    IOL_SPIN_PAUSE();
+
 #if !defined(linux)
   std::unique_lock<std::mutex> lock{mut_};
   cv_.wait(lock, [this] { return state_.load(std::memory_order_relaxed); });
-#endif
-  int old_state = state_.load(std::memory_order_acquire);
-  while (!old_state) {
-    if (local::futex((uint32_t*)&state_, FUTEX_WAIT_PRIVATE, old_state, nullptr, nullptr, 0) ==
-        -1) {
-      // state changed before we could wait
-      if (errno == EAGAIN)
-        return;
-    }
-    old_state = state_.load(std::memory_order_acquire);
+#else
+  int state = state_.load(std::memory_order_acquire);
+  while (state != local::set) {
+    if (state == local::not_set &&
+        !state_.compare_exchange_weak(
+            state, local::not_set_waiting, std::memory_order_acquire, std::memory_order_acquire))
+      continue;
+    // returns right away if set() got there first
+    local::futex(
+        (uint32_t*)&state_, FUTEX_WAIT_PRIVATE, local::not_set_waiting, nullptr, nullptr, 0);
+    state = state_.load(std::memory_order_acquire);
   }
+#endif
 }
 
 bool simple_manual_reset_event::is_set() const
 {
 #if !defined(linux)
-  return state_.load(std::memory_order_relaxed);
+  return state_.load(std::memory_order_acquire);
 #else
-  return state_.load(std::memory_order_relaxed);
+  return state_.load(std::memory_order_acquire) == local::set;
 #endif
 }
 
@@ -1,4 +1,10 @@
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <limits>
+#include <iol/detail/cpu_topology.hpp>
+#include <iol/detail/work_stealing_deque.hpp>
 #include <iol/static_thread_pool.hpp>
 
 namespace
@@ -9,31 +15,181 @@ namespace local
 
 using namespace iol;
 
-struct thread_storage {
+struct placement {
+  std::vector<std::vector<int>> thread_cpus;
+  std::vector<int>              thread_nodes;
+  std::vector<int>              cpu_nodes;
+};
+
+placement make_placement(static_thread_pool::options const& opts, std::size_t n_threads)
+{
+  using thread_placement = static_thread_pool::thread_placement;
+
+  placement result{
+      std::vector<std::vector<int>>(n_threads), std::vector<int>(n_threads, -1), {}};
+
+  if (opts.placement == thread_placement::none)
+    return result;
+
+  auto cpus = detail::available_cpus();
+  if (!opts.cpus.empty())
+    std::erase_if(
+        cpus, [&](auto& cpu) { return std::ranges::find(opts.cpus, cpu.id) == opts.cpus.end(); });
+  if (cpus.empty())
+    return result;
+
+  for (auto& cpu : cpus) {
+    if (result.cpu_nodes.size() <= static_cast<std::size_t>(cpu.id))
+      result.cpu_nodes.resize(cpu.id + 1, -1);
+    result.cpu_nodes[cpu.id] = cpu.node;
+  }
+
+  // groups cpus sharing the same key, in order of first appearance
+  auto const group_by = [&](auto key)
+  {
+    std::vector<std::vector<detail::cpu_info>> groups;
+    for (auto& cpu : cpus) {
+      auto it = std::ranges::find_if(groups, [&](auto& g) { return key(g.front()) == key(cpu); });
+      if (it == groups.end())
+        groups.push_back({cpu});
+      else
+        it->push_back(cpu);
+    }
+    return groups;
+  };
+
+  std::vector<std::vector<detail::cpu_info>> groups;
+  switch (opts.placement) {
+    case thread_placement::cpu_set: groups = {cpus}; break;
+    case thread_placement::spread_cores:
+      groups = group_by([](auto& cpu) { return cpu.core; });
+      break;
+    case thread_placement::spread_nodes:
+      groups = group_by([](auto& cpu) { return cpu.node; });
+      break;
+    default: IOL_UNREACHABLE();
+  }
+
+  for (std::size_t i = 0; i < n_threads; ++i) {
+    auto& group = groups[i % groups.size()];
+    auto  node = group.front().node;
+    for (auto& cpu : group) {
+      result.thread_cpus[i].push_back(cpu.id);
+      if (cpu.node != node)
+        node = -1;
+    }
+    result.thread_nodes[i] = node;
+  }
+
+  return result;
+}
+
+inline std::uint32_t next_random(std::uint32_t& state) noexcept
+{
+  // xorshift32
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+}  // namespace local
+
+}  // namespace
+
+namespace iol
+{
+
+struct static_thread_pool::worker {
+  detail::work_stealing_deque deque{};
+  std::atomic_bool            attached{false};
+  std::atomic_int             node{-1};
+};
 
-  explicit thread_storage(static_thread_pool* p_id)
-    : operation_queue{}, operation_count{0}, previous_storage{top}, pool_id{p_id}
+struct static_thread_pool::thread_storage {
+
+  thread_storage(static_thread_pool* p_id, worker* w, int n)
+    : operation_queue{},
+      operation_count{0},
+      batch{},
+      owned_worker{w},
+      random_state{
+          static_cast<std::uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) |
+          1},
+      node{n},
+      parker{},
+      next_idle{nullptr},
+      previous_storage{top},
+      pool_id{p_id}
   {
     top = this;
   }
 
-  ~thread_storage() { top = previous_storage; }
+  ~thread_storage()
+  {
+    top = previous_storage;
+    if (owned_worker)
+      owned_worker->attached.store(false, std::memory_order_release);
+  }
 
   detail::operation_queue operation_queue;
   std::size_t             operation_count;
 
+  // operations claimed from the main queue but not yet run
+  detail::operation_queue batch;
+
+  // nullptr unless the pool is work stealing and a worker slot was free
+  worker*       owned_worker;
+  std::uint32_t random_state;
+  int           node;
+
+  detail::thread_parker parker;
+  thread_storage*       next_idle;
+
   thread_storage*     previous_storage;
   static_thread_pool* pool_id;
 
   inline static thread_local thread_storage* top = nullptr;
 };
 
-}  // namespace local
+struct static_thread_pool::timer_service {
 
-}  // namespace
+  using tick_type = detail::timer_wheel::tick_type;
 
-namespace iol
-{
+  using tick_duration = std::chrono::milliseconds;
+
+  // the timer thread looks at the clock at least this often
+  static constexpr tick_type max_sleep = 60 * 60 * 1000;
+
+  timer_service() : epoch{clock_type::now()}, wheel{}, wake_tick{0}, stopping{false}, thread{} {}
+
+  // rounds down, a tick is only reached once it has fully passed
+  tick_type tick_at(clock_type::time_point time) const noexcept
+  {
+    return time <= epoch ? 0 : std::chrono::floor<tick_duration>(time - epoch).count();
+  }
+
+  // rounds up, timers never fire early
+  tick_type deadline_tick(clock_type::time_point deadline) const noexcept
+  {
+    return deadline <= epoch ? 0 : std::chrono::ceil<tick_duration>(deadline - epoch).count();
+  }
+
+  clock_type::time_point time_of(tick_type tick) const noexcept
+  {
+    return epoch + tick_duration{tick};
+  }
+
+  clock_type::time_point epoch;
+  detail::timer_wheel    wheel;
+
+  // the tick the timer thread sleeps until, 0 while it is awake
+  tick_type wake_tick;
+  bool      stopping;
+
+  detail::fast_mutex::cond_var cv;
+  std::thread                  thread;
+};
 
 void static_thread_pool::schedule_coro_operation::invoke_impl(
     void* owner, detail::operation_base* base)
@@ -44,20 +200,54 @@ void static_thread_pool::schedule_coro_operation::invoke_impl(
   }
 }
 
-static_thread_pool::static_thread_pool(std::size_t n_threads)
-  : running_{true}, work_count_{1}, main_operation_queue_{}, mut_{}, cv_{}, threads_{}
+void static_thread_pool::schedule_timer_operation::invoke_impl(
+    void* owner, detail::operation_base* base)
+{
+  auto* this_ = static_cast<schedule_timer_operation*>(base);
+  if (owner) {
+    this_->continuation_.resume();
+  }
+}
+
+static_thread_pool::static_thread_pool(std::size_t n_threads, options const& opts)
+  : options_{opts},
+    thread_count_{n_threads ? n_threads : 1},
+    running_{true},
+    work_count_{1},
+    idle_count_{0},
+    main_operation_queue_{},
+    workers_{},
+    mut_{},
+    idle_mut_{},
+    idle_list_{nullptr},
+    threads_{},
+    timer_mut_{},
+    timers_{}
 {
 
-  n_threads = n_threads ? n_threads : 1;
+  n_threads = thread_count_;
+
+  if (options_.mode == scheduling_mode::work_stealing) {
+    workers_.reserve(n_threads);
+    for (std::size_t i = 0; i < n_threads; ++i)
+      workers_.push_back(std::make_unique<worker>());
+  }
+
+  auto placement = local::make_placement(options_, n_threads);
+  cpu_nodes_ = std::move(placement.cpu_nodes);
+
   try {
-    for (auto i = 0; i < n_threads; ++i)
-      threads_.emplace_back(&static_thread_pool::attach, this);
+    for (std::size_t i = 0; i < n_threads; ++i)
+      threads_.emplace_back(
+          [this, cpus = std::move(placement.thread_cpus[i]), node = placement.thread_nodes[i]]
+          {
+            if (!cpus.empty())
+              detail::pin_this_thread(cpus);
+            attach_worker(node);
+          });
   } catch (...) {
-    {
-      std::unique_lock<std::mutex> lock{mut_};
-      running_.store(false, std::memory_order_relaxed);
-    }
-    cv_.notify_all();
+    running_.store(false, std::memory_order_relaxed);
+    notify_all();
     for (auto& t : threads_)
       if (t.joinable())
         t.join();
@@ -67,19 +257,22 @@ static_thread_pool::static_thread_pool(std::size_t n_threads)
 
 static_thread_pool::~static_thread_pool()
 {
-  {
-    std::unique_lock<std::mutex> lock{mut_};
-    running_.store(false, std::memory_order_relaxed);
-  }
-  cv_.notify_all();
+  running_.store(false, std::memory_order_relaxed);
+  notify_all();
   for (auto& t : threads_)
     if (t.joinable())
       t.join();
+  stop_timers();
 }
 
 void static_thread_pool::attach()
 {
-  local::thread_storage storage{this};
+  attach_worker(current_node());
+}
+
+void static_thread_pool::attach_worker(int node)
+{
+  thread_storage storage{this, claim_worker(node), node};
 
   auto const invoke_local = [&, owner = this]
   {
@@ -89,28 +282,7 @@ void static_thread_pool::attach()
     return storage.operation_count == 1;
   };
 
-  auto const is_running = [&]
-  {
-    return running_.load(std::memory_order_relaxed) &&
-           work_count_.load(std::memory_order_relaxed) > 0;
-  };
-
-  std::unique_lock<std::mutex> lock{mut_};
-
-  while (true) {
-
-    cv_.wait(lock, [&] { return !is_running() || !main_operation_queue_.empty(); });
-
-    if (!is_running())
-      return;
-
-    auto*      op = main_operation_queue_.deque().release();
-    bool const more_ops = !main_operation_queue_.empty();
-
-    lock.unlock();
-
-    if (more_ops)
-      cv_.notify_one();
+  while (auto* op = next_operation(storage).release()) {
 
     op->invoke(this, op);
 
@@ -121,35 +293,33 @@ void static_thread_pool::attach()
       }
     }
 
-    // count is > 1
+    // count is > 1, the queued continuations are handed back by the next call to
+    // next_operation
     if (storage.operation_count) {
       work_count_.fetch_add(
           std::exchange(storage.operation_count, 0) - 1, std::memory_order_relaxed);
     } else if (work_count_.fetch_sub(1, std::memory_order_acq_rel) - 1 == 0) {
-      cv_.notify_all();
+      notify_all();
       return;
     }
-
-    lock.lock();
-    main_operation_queue_.enqueue(std::move(storage.operation_queue));
   }
 }
 
 void static_thread_pool::stop()
 {
   running_.store(false, std::memory_order_relaxed);
-  cv_.notify_all();
+  notify_all();
 }
 
 void static_thread_pool::wait()
 {
-  std::unique_lock<std::mutex> lock{mut_};
+  std::unique_lock<detail::fast_mutex> lock{mut_};
   auto                         threads{std::move(threads_)};
   lock.unlock();
 
   if (!threads.empty()) {
     work_count_.fetch_sub(1, std::memory_order_relaxed);
-    cv_.notify_all();
+    notify_all();
     for (auto& t : threads)
       if (t.joinable())
         t.join();
@@ -158,29 +328,380 @@ void static_thread_pool::wait()
 
 bool static_thread_pool::running_in_this_thread() const noexcept
 {
-  auto* storage_ptr = local::thread_storage::top;
-  while (storage_ptr)
-    if ((storage_ptr++)->pool_id == this)
+  for (auto* storage_ptr = thread_storage::top; storage_ptr;
+       storage_ptr = storage_ptr->previous_storage)
+    if (storage_ptr->pool_id == this)
       return true;
   return false;
 }
 
-void static_thread_pool::enqueue_operation(detail::operation_ptr operation) noexcept
+int static_thread_pool::current_node() const noexcept
 {
+  if (cpu_nodes_.empty())
+    return -1;
+  auto const cpu = detail::current_cpu();
+  return cpu >= 0 && static_cast<std::size_t>(cpu) < cpu_nodes_.size() ? cpu_nodes_[cpu] : -1;
+}
+
+bool static_thread_pool::is_running() const noexcept
+{
+  return running_.load(std::memory_order_relaxed) &&
+         work_count_.load(std::memory_order_relaxed) > 0;
+}
+
+static_thread_pool::worker* static_thread_pool::claim_worker(int node) noexcept
+{
+  for (auto& w : workers_) {
+    if (!w->attached.load(std::memory_order_relaxed) &&
+        !w->attached.exchange(true, std::memory_order_acquire)) {
+      w->node.store(node, std::memory_order_relaxed);
+      return w.get();
+    }
+  }
+  // threads attaching beyond the pool size only help out by stealing
+  return nullptr;
+}
+
+detail::operation_ptr static_thread_pool::next_operation(thread_storage& storage)
+{
+  auto* const owned_worker = storage.owned_worker;
+
+  // continuations left over by the last operation
+  if (!storage.operation_queue.empty()) {
+    if (owned_worker) {
+      while (!storage.operation_queue.empty())
+        owned_worker->deque.push(storage.operation_queue.deque());
+    } else {
+      main_operation_queue_.enqueue(std::move(storage.operation_queue));
+    }
+    notify_idle();
+  }
+
+  bool spun = options_.spin_count == 0;
+
+  while (true) {
+
+    if (!is_running())
+      return nullptr;
+
+    if (!storage.batch.empty())
+      return storage.batch.deque();
+
+    if (!workers_.empty()) {
+      if (owned_worker)
+        if (auto op = owned_worker->deque.pop())
+          return op;
+
+      // don't queue up behind another consumer, go steal instead
+      std::unique_lock<detail::fast_mutex> lock{mut_, std::try_to_lock};
+      if (lock.owns_lock())
+        if (auto op = take_queued(storage, lock))
+          return op;
+
+      if (auto op = next_stolen_operation(storage))
+        return op;
+    }
+
+    std::unique_lock<detail::fast_mutex> lock{mut_};
+
+    if (auto op = take_queued(storage, lock))
+      return op;
+
+    if (has_work()) {
+      // a producer is half way through an enqueue or a deque was refilled since we looked
+      lock.unlock();
+      std::this_thread::yield();
+      continue;
+    }
+
+    if (!spun) {
+      lock.unlock();
+      spun = true;
+      spin_for_work();
+      continue;
+    }
+
+    // register as idle before the last look for work, either a producer sees us on the idle
+    // list or we see its work
+    {
+      std::scoped_lock<detail::fast_mutex> idle_lock{idle_mut_};
+      storage.next_idle = idle_list_;
+      idle_list_ = &storage;
+      idle_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    bool const cancel = !is_running() || has_work();
+    lock.unlock();
+
+    if (!cancel || !remove_idle(storage))
+      storage.parker.park();
+
+    spun = options_.spin_count == 0;
+  }
+}
+
+detail::operation_ptr static_thread_pool::take_queued(
+    thread_storage& storage, std::unique_lock<detail::fast_mutex>& lock)
+{
+  auto op = main_operation_queue_.try_deque();
+  if (!op)
+    return nullptr;
+
+  bool more_ops;
+  if (storage.owned_worker) {
+    // move whatever else is queued over to our deque where the other workers can steal it
+    detail::operation_queue batch;
+    more_ops =
+        main_operation_queue_.try_deque(batch, std::numeric_limits<std::size_t>::max()) != 0;
+    lock.unlock();
+    while (!batch.empty())
+      storage.owned_worker->deque.push(batch.deque());
+  } else {
+    auto const fair_share =
+        std::max<std::size_t>(work_count_.load(std::memory_order_relaxed) / thread_count_, 1);
+    if (auto const n = std::min(options_.batch_size, fair_share); n > 1)
+      main_operation_queue_.try_deque(storage.batch, n - 1);
+    more_ops = !main_operation_queue_.empty();
+    lock.unlock();
+  }
+
+  if (more_ops)
+    notify_idle();
+
+  return op;
+}
+
+bool static_thread_pool::has_work() const noexcept
+{
+  if (!main_operation_queue_.empty())
+    return true;
+  for (auto& w : workers_)
+    if (!w->deque.empty())
+      return true;
+  return false;
+}
+
+detail::operation_ptr static_thread_pool::next_stolen_operation(thread_storage& storage)
+{
+  auto const n_workers = workers_.size();
+  auto const start = local::next_random(storage.random_state) % n_workers;
+  // victims on our own node first
+  for (int pass = storage.node < 0; pass < 2; ++pass) {
+    for (std::size_t i = 0; i < n_workers; ++i) {
+      auto& victim = *workers_[(start + i) % n_workers];
+      if (&victim == storage.owned_worker)
+        continue;
+      if (pass == 0 && victim.node.load(std::memory_order_relaxed) != storage.node)
+        continue;
+      if (auto op = victim.deque.steal())
+        return op;
+    }
+  }
+  return nullptr;
+}
+
+void static_thread_pool::spin_for_work() const noexcept
+{
+  for (auto spins = options_.spin_count; spins; --spins) {
+    IOL_SPIN_PAUSE();
+    if (!is_running() || !main_operation_queue_.likely_empty())
+      return;
+    for (auto& w : workers_)
+      if (!w->deque.empty())
+        return;
+  }
+}
+
+bool static_thread_pool::remove_idle(thread_storage& storage) noexcept
+{
+  std::scoped_lock<detail::fast_mutex> lock{idle_mut_};
+  for (auto** link = &idle_list_; *link; link = &(*link)->next_idle) {
+    if (*link == &storage) {
+      *link = storage.next_idle;
+      idle_count_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void static_thread_pool::notify_idle(std::size_t count) noexcept
+{
+  // pairs with the fence in next_operation, either the idle worker sees the new work or we see
+  // the idle worker
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!idle_count_.load(std::memory_order_relaxed))
+    return;
+
+  int node = -1;
+  if (!cpu_nodes_.empty()) {
+    auto* storage = thread_storage::top;
+    node = storage && storage->pool_id == this ? storage->node : current_node();
+  }
+
+  // the sleepers to wake up, linked through next_idle once off the idle list
+  thread_storage* sleepers = nullptr;
+  {
+    std::scoped_lock<detail::fast_mutex> lock{idle_mut_};
+    for (; count && idle_list_; --count) {
+      // prefer a sleeper on the same node, otherwise the most recently parked
+      auto** link = &idle_list_;
+      if (node >= 0) {
+        while (*link && (*link)->node != node)
+          link = &(*link)->next_idle;
+        if (!*link)
+          link = &idle_list_;
+      }
+      auto* sleeper = *link;
+      *link = sleeper->next_idle;
+      sleeper->next_idle = std::exchange(sleepers, sleeper);
+      idle_count_.fetch_sub(1, std::memory_order_relaxed);
+    }
+  }
+  while (sleepers) {
+    auto* next = sleepers->next_idle;
+    sleepers->parker.unpark();
+    sleepers = next;
+  }
+}
+
+void static_thread_pool::notify_all() noexcept
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  thread_storage* sleepers;
   {
-    std::unique_lock<std::mutex> lock{mut_};
-    main_operation_queue_.enqueue(std::move(operation));
-    work_count_.fetch_add(1, std::memory_order_relaxed);
+    std::scoped_lock<detail::fast_mutex> lock{idle_mut_};
+    sleepers = std::exchange(idle_list_, nullptr);
+    idle_count_.store(0, std::memory_order_relaxed);
+  }
+  while (sleepers) {
+    auto* next = sleepers->next_idle;
+    sleepers->parker.unpark();
+    sleepers = next;
   }
-  cv_.notify_one();
+}
+
+void static_thread_pool::enqueue_operation(detail::operation_ptr operation) noexcept
+{
+  work_count_.fetch_add(1, std::memory_order_relaxed);
+  main_operation_queue_.enqueue(std::move(operation));
+  notify_idle();
+}
+
+void static_thread_pool::enqueue_operations(
+    detail::operation_queue&& operations, std::size_t count) noexcept
+{
+  if (!count)
+    return;
+  work_count_.fetch_add(count, std::memory_order_relaxed);
+  main_operation_queue_.enqueue(std::move(operations));
+  notify_idle(count);
 }
 
 void static_thread_pool::enqueue_continuation(detail::operation_ptr operation) noexcept
 {
-  auto* storage = local::thread_storage::top;
+  auto* storage = thread_storage::top;
   IOL_ASSERT(storage && storage->pool_id == this);
   storage->operation_queue.enqueue(std::move(operation));
   ++storage->operation_count;
 }
 
+void static_thread_pool::add_timer(timer_operation& operation) noexcept
+{
+  if (operation.deadline > clock_type::now()) {
+    detail::fast_mutex::scoped_lock lock{timer_mut_};
+    if (!timers_) {
+      timers_ = std::make_unique<timer_service>();
+      timers_->thread = std::thread{[this, timers = timers_.get()] { run_timers(*timers); }};
+    }
+
+    auto&      timers = *timers_;
+    auto const tick = timers.deadline_tick(operation.deadline);
+    if (timers.wheel.insert(operation, tick)) {
+      work_count_.fetch_add(1, std::memory_order_relaxed);
+      if (tick < timers.wake_tick) {
+        timers.wake_tick = tick;
+        timers.cv.notify_one();
+      }
+      return;
+    }
+  }
+
+  auto op = detail::operation_ptr{&operation};
+  if (running_in_this_thread())
+    enqueue_continuation(std::move(op));
+  else
+    enqueue_operation(std::move(op));
+}
+
+bool static_thread_pool::cancel_timer(timer_operation& operation) noexcept
+{
+  {
+    detail::fast_mutex::scoped_lock lock{timer_mut_};
+    if (!operation.prev_timer)
+      return false;
+    timers_->wheel.erase(operation);
+    operation.cancelled = true;
+  }
+
+  // counted as work when it was added
+  main_operation_queue_.enqueue(detail::operation_ptr{&operation});
+  notify_idle();
+  return true;
+}
+
+void static_thread_pool::run_timers(timer_service& timers)
+{
+  detail::fast_mutex::scoped_lock lock{timer_mut_};
+  while (!timers.stopping) {
+    detail::operation_queue expired;
+    std::size_t             count = 0;
+    for (auto* node = timers.wheel.advance(timers.tick_at(clock_type::now())); node; ++count) {
+      auto* op = static_cast<timer_operation*>(std::exchange(node, node->next_timer));
+      expired.enqueue(detail::operation_ptr{op});
+    }
+
+    if (count) {
+      // counted as work when they were added
+      lock.unlock();
+      main_operation_queue_.enqueue(std::move(expired));
+      notify_idle(count);
+      lock.lock();
+      continue;
+    }
+
+    timers.wake_tick =
+        std::min(timers.wheel.next_tick(), timers.wheel.now() + timer_service::max_sleep);
+    timers.cv.wait_until(lock, timers.time_of(timers.wake_tick));
+    timers.wake_tick = 0;
+  }
+}
+
+void static_thread_pool::stop_timers() noexcept
+{
+  {
+    detail::fast_mutex::scoped_lock lock{timer_mut_};
+    if (!timers_)
+      return;
+    timers_->stopping = true;
+    timers_->cv.notify_one();
+  }
+  timers_->thread.join();
+
+  // completing a timer may add another one
+  while (true) {
+    detail::fast_mutex::scoped_lock lock{timer_mut_};
+    auto*                           node = timers_->wheel.take_all();
+    lock.unlock();
+    if (!node)
+      break;
+    while (node) {
+      auto* op = static_cast<timer_operation*>(std::exchange(node, node->next_timer));
+      op->invoke(nullptr, op);
+    }
+  }
+}
+
 }  // namespace iol
@@ -0,0 +1,273 @@
+#include <iol/thread_caching_allocator.hpp>
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol::detail;
+
+constexpr std::size_t chunk_size = 64 * 1024;
+
+// 16, 32, 48, 64, then two classes per power of two up to 4096
+constexpr std::size_t class_count = 16;
+
+// remote frees a thread collects for one owner before handing them back
+constexpr std::size_t batch_size = 32;
+
+// owners a thread collects remote frees for at the same time
+constexpr std::size_t pending_owners = 8;
+
+inline constexpr std::size_t size_class_of(std::size_t size) noexcept
+{
+  if (size <= 64)
+    return size ? (size - 1) / 16 : 0;
+  auto const k = static_cast<std::size_t>(std::bit_width(size - 1));
+  return 4 + 2 * (k - 7) + (size > (std::size_t{3} << (k - 2)));
+}
+
+inline constexpr std::size_t class_size(std::size_t size_class) noexcept
+{
+  if (size_class < 4)
+    return (size_class + 1) * 16;
+  auto const k = 7 + (size_class - 4) / 2;
+  return size_class % 2 ? std::size_t{1} << k : std::size_t{3} << (k - 2);
+}
+
+static_assert(size_class_of(thread_caching::max_size) == class_count - 1);
+static_assert(class_size(class_count - 1) == thread_caching::max_size);
+
+struct thread_cache;
+
+struct alignas(64) chunk_header {
+  thread_cache* owner;
+  std::size_t   size_class;
+};
+
+struct free_slot {
+  free_slot* next;
+};
+
+inline chunk_header* chunk_of(void* p) noexcept
+{
+  return reinterpret_cast<chunk_header*>(reinterpret_cast<std::uintptr_t>(p) & ~(chunk_size - 1));
+}
+
+inline free_slot* closed() noexcept
+{
+  return reinterpret_cast<free_slot*>(alignof(free_slot));
+}
+
+/*
+ * While its thread runs the cache counts live allocations in live_, once the thread exited
+ * the count moves to orphaned_ and whoever brings it down to zero frees the cache.
+ * */
+struct thread_cache {
+
+  struct size_class_state {
+    free_slot* free = nullptr;
+    std::byte* bump = nullptr;
+    std::byte* bump_end = nullptr;
+  };
+
+  thread_cache() = default;
+
+  thread_cache(thread_cache&&) = delete;
+
+  ~thread_cache()
+  {
+    for (auto* chunk : chunks_)
+      ::operator delete(chunk, std::align_val_t{chunk_size});
+  }
+
+  // owner only
+  void* allocate(std::size_t size_class)
+  {
+    auto& state = classes_[size_class];
+    if (!state.free)
+      reclaim_remote();
+
+    if (auto* slot = state.free) {
+      state.free = slot->next;
+      ++live_;
+      return slot;
+    }
+
+    auto const size = class_size(size_class);
+    if (static_cast<std::size_t>(state.bump_end - state.bump) < size) {
+      chunks_.reserve(chunks_.size() + 1);
+      auto* chunk = static_cast<std::byte*>(
+          ::operator new(chunk_size, std::align_val_t{chunk_size}));
+      chunks_.push_back(chunk);
+      ::new (chunk) chunk_header{this, size_class};
+      state.bump = chunk + sizeof(chunk_header);
+      state.bump_end = chunk + chunk_size;
+    }
+
+    auto* p = state.bump;
+    state.bump += size;
+    ++live_;
+    return p;
+  }
+
+  // owner only
+  void deallocate(void* p, std::size_t size_class) noexcept
+  {
+    auto* slot = static_cast<free_slot*>(p);
+    slot->next = std::exchange(classes_[size_class].free, slot);
+    --live_;
+  }
+
+  // any thread but the owner
+  void push_remote(free_slot* first, free_slot* last, std::size_t count) noexcept
+  {
+    auto head = remote_.load(std::memory_order_relaxed);
+    do {
+      if (head == closed()) {
+        release_orphaned(count);
+        return;
+      }
+      last->next = head;
+    } while (!remote_.compare_exchange_weak(
+        head, first, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  // owner only, on thread exit
+  void close() noexcept
+  {
+    reclaim(remote_.exchange(closed(), std::memory_order_acquire));
+    // remote threads may already be subtracting, the counter wraps until this lands
+    auto const live = live_;
+    if (orphaned_.fetch_add(live, std::memory_order_acq_rel) + live == 0)
+      delete this;
+  }
+
+private:
+
+  void reclaim_remote() noexcept
+  {
+    if (remote_.load(std::memory_order_relaxed))
+      reclaim(remote_.exchange(nullptr, std::memory_order_acquire));
+  }
+
+  void reclaim(free_slot* slot) noexcept
+  {
+    while (slot) {
+      auto* next = slot->next;
+      deallocate(slot, chunk_of(slot)->size_class);
+      slot = next;
+    }
+  }
+
+  void release_orphaned(std::size_t count) noexcept
+  {
+    if (orphaned_.fetch_sub(count, std::memory_order_acq_rel) == count)
+      delete this;
+  }
+
+  size_class_state   classes_[class_count];
+  std::vector<void*> chunks_;
+  std::size_t        live_ = 0;
+
+  alignas(64) std::atomic<free_slot*> remote_{nullptr};
+  std::atomic_size_t orphaned_{0};
+};
+
+struct pending_batch {
+  thread_cache* owner;
+  free_slot*    first;
+  free_slot*    last;
+  std::size_t   count;
+};
+
+inline void flush(pending_batch& batch) noexcept
+{
+  if (batch.count)
+    batch.owner->push_remote(batch.first, batch.last, batch.count);
+  batch = {};
+}
+
+thread_local thread_cache* current_cache = nullptr;
+
+thread_local bool thread_exited = false;
+
+thread_local pending_batch pending[pending_owners] = {};
+
+struct thread_guard {
+  ~thread_guard()
+  {
+    for (auto& batch : pending)
+      flush(batch);
+    if (current_cache)
+      std::exchange(current_cache, nullptr)->close();
+    thread_exited = true;
+  }
+};
+
+thread_local thread_guard guard;
+
+}  // namespace local
+
+}  // namespace
+
+namespace iol::detail::thread_caching
+{
+
+void* allocate(std::size_t size)
+{
+  IOL_ASSERT(size <= max_size);
+
+  auto const size_class = local::size_class_of(size);
+  if (!local::current_cache) [[unlikely]] {
+    static_cast<void>(&local::guard);
+    auto cache = std::make_unique<local::thread_cache>();
+    if (local::thread_exited) {
+      // the thread is tearing down, the cache is orphaned right away
+      auto* p = cache->allocate(size_class);
+      cache.release()->close();
+      return p;
+    }
+    local::current_cache = cache.release();
+  }
+  return local::current_cache->allocate(size_class);
+}
+
+void deallocate(void* p) noexcept
+{
+  auto* chunk = local::chunk_of(p);
+  auto* owner = chunk->owner;
+  auto* slot = static_cast<local::free_slot*>(p);
+
+  if (owner == local::current_cache) {
+    owner->deallocate(p, chunk->size_class);
+    return;
+  }
+
+  if (local::thread_exited) {
+    owner->push_remote(slot, slot, 1);
+    return;
+  }
+
+  static_cast<void>(&local::guard);
+  auto& batch = local::pending[(reinterpret_cast<std::uintptr_t>(owner) >> 6) %
+                               local::pending_owners];
+  if (batch.owner != owner) {
+    local::flush(batch);
+    batch.owner = owner;
+    batch.last = slot;
+  }
+  slot->next = std::exchange(batch.first, slot);
+  if (++batch.count == local::batch_size)
+    local::flush(batch);
+}
+
+}  // namespace iol::detail::thread_caching
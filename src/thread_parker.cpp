@@ -0,0 +1,84 @@
+#include <iol/detail/thread_parker.hpp>
+
+#if defined(linux)
+
+#include <linux/futex.h> /* Definition of FUTEX_* constants */
+#include <sys/syscall.h> /* Definition of SYS_* constants */
+#include <unistd.h>
+
+namespace
+{
+
+namespace local
+{
+
+inline long futex(
+    uint32_t* uaddr, int futex_op, uint32_t val, timespec const* timeout, uint32_t* uaddr2,
+    uint32_t val3)
+{
+  return syscall(SYS_futex, uaddr, futex_op, val, timeout, uaddr2, val3);
+}
+
+enum : std::uint32_t { empty = 0, notified = 1, parked = ~std::uint32_t{0} };
+
+}  // namespace local
+
+}  // namespace
+
+#endif
+
+namespace iol::detail
+{
+
+#if !defined(linux)
+
+thread_parker::thread_parker() noexcept : mut_{}, cv_{}, notified_{false} {}
+
+void thread_parker::park()
+{
+  std::unique_lock<std::mutex> lock{mut_};
+  cv_.wait(lock, [this] { return notified_; });
+  notified_ = false;
+}
+
+void thread_parker::unpark()
+{
+  // notified_ is only read under the lock, the parker can't return and destroy the condition
+  // variable before notify_one() is done
+  std::scoped_lock<std::mutex> lock{mut_};
+  notified_ = true;
+  cv_.notify_one();
+}
+
+#else
+
+thread_parker::thread_parker() noexcept : state_{local::empty} {}
+
+void thread_parker::park()
+{
+  // notified -> empty, or empty -> parked
+  if (state_.fetch_sub(1, std::memory_order_acquire) == local::notified)
+    return;
+
+  while (true) {
+    local::futex((std::uint32_t*)&state_, FUTEX_WAIT_PRIVATE, local::parked, nullptr, nullptr, 0);
+    auto expected = std::uint32_t{local::notified};
+    if (state_.compare_exchange_strong(
+            expected, local::empty, std::memory_order_acquire, std::memory_order_relaxed))
+      return;
+    // spurious wake up
+  }
+}
+
+void thread_parker::unpark()
+{
+  if (state_.exchange(local::notified, std::memory_order_release) == local::parked) {
+    [[maybe_unused]] auto n_awoken =
+        local::futex((std::uint32_t*)&state_, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+    IOL_ASSERT(n_awoken != -1);
+  }
+}
+
+#endif
+
+}  // namespace iol::detail
@@ -0,0 +1,166 @@
+#include <iol/detail/timer_wheel.hpp>
+
+#include <bit>
+
+namespace
+{
+
+namespace local
+{
+
+using iol::detail::timer_wheel;
+
+constexpr std::size_t slot_mask = timer_wheel::slot_count - 1;
+
+constexpr std::size_t shift_of(std::size_t level) noexcept
+{
+  return level * timer_wheel::level_bits;
+}
+
+}  // namespace local
+
+}  // namespace
+
+namespace iol::detail
+{
+
+timer_wheel::timer_wheel() noexcept : now_{0}, slots_{}, occupied_{}
+{
+  for (auto& head : slots_)
+    head.next_timer = head.prev_timer = &head;
+}
+
+bool timer_wheel::empty() const noexcept
+{
+  for (auto occupied : occupied_)
+    if (occupied)
+      return false;
+  return true;
+}
+
+bool timer_wheel::insert(timer_node& node, tick_type expiry) noexcept
+{
+  IOL_ASSERT(!node.prev_timer);
+  node.expiry = expiry < max_tick ? expiry : max_tick;
+  if (node.expiry <= now_)
+    return false;
+  link(node);
+  return true;
+}
+
+void timer_wheel::erase(timer_node& node) noexcept
+{
+  IOL_ASSERT(node.prev_timer);
+  node.prev_timer->next_timer = node.next_timer;
+  node.next_timer->prev_timer = node.prev_timer;
+
+  // only the head is left
+  if (node.next_timer == node.prev_timer) {
+    auto const index = static_cast<std::size_t>(node.next_timer - slots_.data());
+    occupied_[index / slot_count] &= ~(std::uint64_t{1} << (index & local::slot_mask));
+  }
+  node.next_timer = node.prev_timer = nullptr;
+}
+
+timer_wheel::tick_type timer_wheel::next_tick() const noexcept
+{
+  // everything pending on a level comes before the next slot of the level above
+  for (std::size_t level = 0; level < level_count; ++level) {
+    auto const shift = local::shift_of(level);
+    auto const current = (now_ >> shift) & local::slot_mask;
+    auto const pending = occupied_[level] & ~((std::uint64_t{2} << current) - 1);
+    if (!pending)
+      continue;
+    auto const block = now_ & ~((tick_type{1} << local::shift_of(level + 1)) - 1);
+    return block + (static_cast<tick_type>(std::countr_zero(pending)) << shift);
+  }
+  return no_tick;
+}
+
+timer_node* timer_wheel::advance(tick_type tick) noexcept
+{
+  timer_node* expired = nullptr;
+
+  auto const expire = [&](timer_node* node)
+  {
+    node->prev_timer = nullptr;
+    node->next_timer = expired;
+    expired = node;
+  };
+
+  for (auto next = next_tick(); next <= tick; next = next_tick()) {
+    now_ = next;
+
+    // the slots just reached on the upper levels move their timers down
+    for (auto level = level_count - 1; level > 0; --level) {
+      auto const shift = local::shift_of(level);
+      if (now_ & ((tick_type{1} << shift) - 1))
+        continue;
+      auto* node = unlink_slot(level, (now_ >> shift) & local::slot_mask);
+      while (node) {
+        auto* next_node = node->next_timer;
+        if (node->expiry <= now_)
+          expire(node);
+        else
+          link(*node);
+        node = next_node;
+      }
+    }
+
+    for (auto* node = unlink_slot(0, now_ & local::slot_mask); node;) {
+      auto* next_node = node->next_timer;
+      expire(node);
+      node = next_node;
+    }
+  }
+
+  if (now_ < tick)
+    now_ = tick < max_tick ? tick : max_tick;
+  return expired;
+}
+
+timer_node* timer_wheel::take_all() noexcept
+{
+  timer_node* all = nullptr;
+  for (std::size_t level = 0; level < level_count; ++level) {
+    while (occupied_[level]) {
+      auto* node = unlink_slot(level, std::countr_zero(occupied_[level]));
+      while (node) {
+        auto* next_node = node->next_timer;
+        node->prev_timer = nullptr;
+        node->next_timer = all;
+        all = node;
+        node = next_node;
+      }
+    }
+  }
+  return all;
+}
+
+void timer_wheel::link(timer_node& node) noexcept
+{
+  auto const level = (std::bit_width(node.expiry ^ now_) - 1) / level_bits;
+  auto const slot = (node.expiry >> local::shift_of(level)) & local::slot_mask;
+  auto&      head = slots_[level * slot_count + slot];
+
+  node.next_timer = &head;
+  node.prev_timer = head.prev_timer;
+  head.prev_timer->next_timer = &node;
+  head.prev_timer = &node;
+  occupied_[level] |= std::uint64_t{1} << slot;
+}
+
+timer_node* timer_wheel::unlink_slot(std::size_t level, std::size_t slot) noexcept
+{
+  auto& head = slots_[level * slot_count + slot];
+  if (head.next_timer == &head)
+    return nullptr;
+
+  auto* first = head.next_timer;
+  head.prev_timer->next_timer = nullptr;
+  head.next_timer = head.prev_timer = &head;
+  occupied_[level] &= ~(std::uint64_t{1} << slot);
+  return first;
+}
+
+}  // namespace iol::detail
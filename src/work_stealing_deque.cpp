@@ -0,0 +1,129 @@
+#include <iol/detail/work_stealing_deque.hpp>
+
+#include <bit>
+#include <utility>
+
+namespace iol::detail
+{
+
+class work_stealing_deque::buffer
+{
+
+public:
+
+  explicit buffer(std::size_t capacity)
+    : mask_{capacity - 1}, slots_{new std::atomic<operation_base*>[capacity]}
+  {
+    IOL_ASSERT(std::has_single_bit(capacity));
+  }
+
+  std::int64_t capacity() const noexcept { return static_cast<std::int64_t>(mask_ + 1); }
+
+  operation_base* load(std::int64_t index) const noexcept
+  {
+    return slots_[index & mask_].load(std::memory_order_relaxed);
+  }
+
+  void store(std::int64_t index, operation_base* op) noexcept
+  {
+    slots_[index & mask_].store(op, std::memory_order_relaxed);
+  }
+
+private:
+
+  std::size_t                                  mask_;
+  std::unique_ptr<std::atomic<operation_base*>[]> slots_;
+};
+
+work_stealing_deque::work_stealing_deque(std::size_t capacity)
+  : top_{0}, bottom_{0}, buffer_{nullptr}, buffers_{}
+{
+  buffers_.push_back(std::make_unique<buffer>(std::bit_ceil(capacity ? capacity : 1)));
+  buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+}
+
+work_stealing_deque::~work_stealing_deque()
+{
+  while (pop())
+    ;
+}
+
+void work_stealing_deque::push(operation_ptr&& operation)
+{
+  auto const bottom = bottom_.load(std::memory_order_relaxed);
+  auto const top = top_.load(std::memory_order_acquire);
+  auto*      buf = buffer_.load(std::memory_order_relaxed);
+
+  if (bottom - top > buf->capacity() - 1)
+    buf = grow(buf, top, bottom);
+
+  buf->store(bottom, operation.release());
+  bottom_.store(bottom + 1, std::memory_order_release);
+}
+
+operation_ptr work_stealing_deque::pop() noexcept
+{
+  auto const bottom = bottom_.load(std::memory_order_relaxed) - 1;
+  auto*      buf = buffer_.load(std::memory_order_relaxed);
+  bottom_.store(bottom, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto top = top_.load(std::memory_order_relaxed);
+
+  if (top > bottom) {
+    // empty
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+    return nullptr;
+  }
+
+  auto* op = buf->load(bottom);
+  if (top == bottom) {
+    // last element, race against thieves for it
+    if (!top_.compare_exchange_strong(
+            top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      op = nullptr;
+    bottom_.store(bottom + 1, std::memory_order_relaxed);
+  }
+  return operation_ptr{op};
+}
+
+operation_ptr work_stealing_deque::steal() noexcept
+{
+  auto top = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto const bottom = bottom_.load(std::memory_order_acquire);
+
+  if (top >= bottom)
+    return nullptr;
+
+  auto* op = buffer_.load(std::memory_order_acquire)->load(top);
+  if (!top_.compare_exchange_strong(
+          top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    return nullptr;  // lost the race to another thief or the owner
+  return operation_ptr{op};
+}
+
+bool work_stealing_deque::empty() const noexcept
+{
+  return size() == 0;
+}
+
+std::size_t work_stealing_deque::size() const noexcept
+{
+  auto const bottom = bottom_.load(std::memory_order_acquire);
+  auto const top = top_.load(std::memory_order_acquire);
+  return bottom > top ? static_cast<std::size_t>(bottom - top) : 0;
+}
+
+work_stealing_deque::buffer* work_stealing_deque::grow(
+    buffer* old, std::int64_t top, std::int64_t bottom)
+{
+  auto next = std::make_unique<buffer>(static_cast<std::size_t>(old->capacity()) * 2);
+  for (auto i = top; i != bottom; ++i)
+    next->store(i, old->load(i));
+  buffers_.push_back(std::move(next));
+  auto* buf = buffers_.back().get();
+  buffer_.store(buf, std::memory_order_release);
+  return buf;
+}
+
+}  // namespace iol::detail
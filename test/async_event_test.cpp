@@ -0,0 +1,222 @@
+#include "test.hpp"
+
+#include <iol/async_auto_reset_event.hpp>
+#include <iol/async_latch.hpp>
+#include <iol/async_manual_reset_event.hpp>
+#include <iol/awaitable.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+#include <iol/when_all.hpp>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+template <typename Event>
+awaitable<void> record_turn(Event& event, std::vector<int>& order, int id)
+{
+  co_await event;
+  order.push_back(id);
+}
+
+template <typename Event>
+awaitable<void> count_release(Event& event, std::atomic_int& released)
+{
+  co_await event;
+  released.fetch_add(1, std::memory_order_relaxed);
+}
+
+awaitable<void> all(std::vector<awaitable<void>> tasks)
+{
+  co_await when_all(std::move(tasks));
+}
+
+awaitable<void> set_one_at_a_time(async_auto_reset_event& event, std::vector<int> const& order)
+{
+  for (std::size_t n = 1; n <= 4; ++n) {
+    event.set();
+    IOL_CHECK(order.size() == n);
+  }
+  // nobody is waiting, the next co_await goes through
+  event.set();
+  event.set();
+  co_return;
+}
+
+awaitable<void> set_concurrently(
+    async_auto_reset_event& event, std::atomic_int& released, int sets)
+{
+  constexpr int setters = 4;
+
+  std::vector<std::thread> threads;
+  for (int s = 0; s < setters; ++s)
+    threads.emplace_back(
+        [&]
+        {
+          for (int i = 0; i < sets / setters; ++i)
+            event.set();
+        });
+  for (auto& t : threads)
+    t.join();
+
+  // every set() found a waiter, none of them was lost or counted twice
+  IOL_CHECK(released.load() == sets);
+  for (int i = 0; i < sets; ++i)
+    event.set();
+  co_return;
+}
+
+template <typename Event>
+awaitable<void> expect_waiting(Event& event, std::vector<int> const& order, std::size_t n)
+{
+  IOL_CHECK(order.size() == n);
+  event.set();
+  co_return;
+}
+
+awaitable<void> wait_on_pool(static_thread_pool& pool, async_manual_reset_event& event)
+{
+  co_await pool.schedule();
+  co_await event;
+}
+
+awaitable<void> count_down_by(async_latch& latch, std::vector<int> const& order)
+{
+  latch.count_down(2);
+  IOL_CHECK(!latch.is_ready());
+  IOL_CHECK(order.empty());
+  latch.count_down(3);
+  IOL_CHECK(latch.is_ready());
+  IOL_CHECK(order.size() == 2);
+  co_return;
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(async_auto_reset_event_releases_one_waiter_per_set_in_arrival_order)
+{
+  iol::async_auto_reset_event event;
+  std::vector<int>            order;
+
+  std::vector<iol::awaitable<void>> tasks;
+  for (int i = 0; i < 4; ++i)
+    tasks.push_back(local::record_turn(event, order, i));
+  tasks.push_back(local::set_one_at_a_time(event, order));
+  iol::sync_wait(local::all(std::move(tasks)));
+  IOL_CHECK((order == std::vector<int>{0, 1, 2, 3}));
+
+  // the two set() calls without waiters count as one
+  tasks.clear();
+  tasks.push_back(local::record_turn(event, order, 4));
+  tasks.push_back(local::record_turn(event, order, 5));
+  tasks.push_back(local::expect_waiting(event, order, 5));
+  iol::sync_wait(local::all(std::move(tasks)));
+  IOL_CHECK((order == std::vector<int>{0, 1, 2, 3, 4, 5}));
+}
+
+IOL_TEST(async_auto_reset_event_releases_exactly_as_many_waiters_as_sets)
+{
+  constexpr int sets = 2000;
+
+  for (int round = 0; round < 20; ++round) {
+    iol::async_auto_reset_event event;
+    std::atomic_int             released{0};
+
+    // twice as many waiters as sets, all of them queued before the first set()
+    std::vector<iol::awaitable<void>> tasks;
+    for (int i = 0; i < 2 * sets; ++i)
+      tasks.push_back(local::count_release(event, released));
+    tasks.push_back(local::set_concurrently(event, released, sets));
+    iol::sync_wait(local::all(std::move(tasks)));
+    IOL_CHECK(released.load() == 2 * sets);
+  }
+}
+
+IOL_TEST(async_auto_reset_event_reset_drops_a_pending_set)
+{
+  iol::async_auto_reset_event event{true};
+  std::vector<int>            order;
+  event.reset();
+  // no effect without a pending set()
+  event.reset();
+
+  std::vector<iol::awaitable<void>> tasks;
+  tasks.push_back(local::record_turn(event, order, 0));
+  tasks.push_back(local::expect_waiting(event, order, 0));
+  iol::sync_wait(local::all(std::move(tasks)));
+  IOL_CHECK((order == std::vector<int>{0}));
+}
+
+IOL_TEST(async_manual_reset_event_stays_set_until_reset)
+{
+  iol::async_manual_reset_event event;
+  std::vector<int>              order;
+
+  std::vector<iol::awaitable<void>> tasks;
+  for (int i = 0; i < 3; ++i)
+    tasks.push_back(local::record_turn(event, order, i));
+  tasks.push_back(local::expect_waiting(event, order, 0));
+  iol::sync_wait(local::all(std::move(tasks)));
+  IOL_CHECK(event.is_set());
+  IOL_CHECK(order.size() == 3);
+
+  // goes straight through while set
+  iol::sync_wait(local::record_turn(event, order, 3));
+  IOL_CHECK(order.size() == 4);
+
+  event.reset();
+  IOL_CHECK(!event.is_set());
+  tasks.clear();
+  tasks.push_back(local::record_turn(event, order, 4));
+  tasks.push_back(local::expect_waiting(event, order, 4));
+  iol::sync_wait(local::all(std::move(tasks)));
+  IOL_CHECK(order.size() == 5);
+}
+
+IOL_TEST(async_manual_reset_event_set_races_co_await)
+{
+  iol::static_thread_pool pool{4};
+  for (int round = 0; round < 200; ++round) {
+    iol::async_manual_reset_event event;
+
+    std::vector<iol::awaitable<void>> tasks;
+    for (int i = 0; i < 16; ++i)
+      tasks.push_back(local::wait_on_pool(pool, event));
+    std::thread setter{[&] { event.set(); }};
+    iol::sync_wait(local::all(std::move(tasks)));
+    setter.join();
+    IOL_CHECK(event.is_set());
+  }
+}
+
+IOL_TEST(async_latch_releases_waiters_once_counted_down_to_zero)
+{
+  iol::async_latch latch{5};
+  std::vector<int> order;
+
+  std::vector<iol::awaitable<void>> tasks;
+  tasks.push_back(local::record_turn(latch, order, 0));
+  tasks.push_back(local::record_turn(latch, order, 1));
+  tasks.push_back(local::count_down_by(latch, order));
+  iol::sync_wait(local::all(std::move(tasks)));
+
+  // already at zero, counting further keeps it there
+  latch.count_down();
+  IOL_CHECK(latch.is_ready());
+  iol::sync_wait(local::record_turn(latch, order, 2));
+  IOL_CHECK(order.size() == 3);
+  IOL_CHECK(order.back() == 2);
+
+  iol::async_latch done{0};
+  IOL_CHECK(done.is_ready());
+}
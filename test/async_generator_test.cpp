@@ -0,0 +1,113 @@
+#include "test.hpp"
+
+#include <iol/async_generator.hpp>
+#include <iol/awaitable.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+async_generator<int> count_to(int n)
+{
+  for (int i = 0; i < n; ++i)
+    co_yield i;
+}
+
+awaitable<int> leaf(int i)
+{
+  co_return i;
+}
+
+// moves to the pool halfway through
+async_generator<int> awaits_between(static_thread_pool& pool, int n)
+{
+  for (int i = 0; i < n; ++i) {
+    if (i == n / 2)
+      co_await pool.schedule();
+    co_yield co_await leaf(i);
+  }
+}
+
+async_generator<int> throws_after(int n)
+{
+  for (int i = 0; i < n; ++i)
+    co_yield i;
+  throw std::runtime_error{"async_generator"};
+}
+
+awaitable<std::vector<int>> consume(async_generator<int> gen)
+{
+  std::vector<int> seen;
+  for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it)
+    seen.push_back(*it);
+  co_return seen;
+}
+
+struct outcome {
+  std::vector<int> seen;
+  bool             thrown = false;
+};
+
+awaitable<outcome> consume_until_thrown(async_generator<int> gen)
+{
+  outcome result;
+  try {
+    for (auto it = co_await gen.begin(); it != gen.end(); co_await ++it)
+      result.seen.push_back(*it);
+  } catch (std::runtime_error const&) {
+    result.thrown = true;
+  }
+  co_return result;
+}
+
+awaitable<bool> begins_at_the_end(async_generator<int> gen)
+{
+  co_return co_await gen.begin() == gen.end();
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(async_generator_yields_in_order)
+{
+  auto const seen = iol::sync_wait(local::consume(local::count_to(100000)));
+  IOL_CHECK(seen.size() == 100000);
+  for (int i = 0; i < 100000; ++i)
+    IOL_CHECK(seen[i] == i);
+}
+
+IOL_TEST(async_generator_body_co_awaits_between_yields)
+{
+  iol::static_thread_pool pool{2};
+  auto const              seen = iol::sync_wait(local::consume(local::awaits_between(pool, 1000)));
+  IOL_CHECK(seen.size() == 1000);
+  for (int i = 0; i < 1000; ++i)
+    IOL_CHECK(seen[i] == i);
+}
+
+IOL_TEST(async_generator_rethrows_from_begin_and_increment)
+{
+  auto const from_begin = iol::sync_wait(local::consume_until_thrown(local::throws_after(0)));
+  IOL_CHECK(from_begin.thrown);
+  IOL_CHECK(from_begin.seen.empty());
+
+  auto const from_increment = iol::sync_wait(local::consume_until_thrown(local::throws_after(3)));
+  IOL_CHECK(from_increment.thrown);
+  IOL_CHECK((from_increment.seen == std::vector<int>{0, 1, 2}));
+}
+
+IOL_TEST(async_generator_empty_begins_at_the_end)
+{
+  IOL_CHECK(iol::sync_wait(local::begins_at_the_end(local::count_to(0))));
+  IOL_CHECK(iol::sync_wait(local::begins_at_the_end(iol::async_generator<int>{})));
+}
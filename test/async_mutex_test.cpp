@@ -0,0 +1,98 @@
+#include "test.hpp"
+
+#include <iol/async_mutex.hpp>
+#include <iol/awaitable.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+#include <iol/when_all.hpp>
+
+#include <atomic>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+struct shared_state {
+  async_mutex      mutex;
+  std::atomic_bool inside{false};
+  bool             overlapped = false;
+  long             counter = 0;
+};
+
+awaitable<void> increment(static_thread_pool& pool, shared_state& state, int n)
+{
+  co_await pool.schedule();
+  for (int i = 0; i < n; ++i) {
+    auto lock = co_await state.mutex.scoped_lock_on(pool);
+    if (state.inside.exchange(true, std::memory_order_relaxed))
+      state.overlapped = true;
+    ++state.counter;
+    state.inside.store(false, std::memory_order_relaxed);
+    // lets the other tasks queue up behind the lock
+    if (i % 64 == 0)
+      co_await pool.schedule();
+  }
+}
+
+awaitable<void> record_turn(async_mutex& mutex, std::vector<int>& order, int id)
+{
+  auto lock = co_await mutex.scoped_lock();
+  order.push_back(id);
+}
+
+awaitable<void> release(async_mutex& mutex)
+{
+  mutex.unlock();
+  co_return;
+}
+
+awaitable<void> all(std::vector<awaitable<void>> tasks)
+{
+  co_await when_all(std::move(tasks));
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(async_mutex_excludes_tasks_on_a_pool)
+{
+  constexpr int tasks = 8;
+  constexpr int per_task = 2000;
+
+  iol::static_thread_pool pool{4};
+  local::shared_state     state;
+
+  std::vector<iol::awaitable<void>> increments;
+  for (int i = 0; i < tasks; ++i)
+    increments.push_back(local::increment(pool, state, per_task));
+  iol::sync_wait(local::all(std::move(increments)));
+
+  IOL_CHECK(!state.overlapped);
+  IOL_CHECK(state.counter == long{tasks} * per_task);
+  IOL_CHECK(state.mutex.try_lock());
+  state.mutex.unlock();
+}
+
+IOL_TEST(async_mutex_hands_over_in_arrival_order)
+{
+  iol::async_mutex mutex;
+  std::vector<int> order;
+  IOL_CHECK(mutex.try_lock());
+
+  // each waiter queues up in turn, then the last task lets go of the lock
+  std::vector<iol::awaitable<void>> tasks;
+  for (int i = 0; i < 4; ++i)
+    tasks.push_back(local::record_turn(mutex, order, i));
+  tasks.push_back(local::release(mutex));
+  iol::sync_wait(local::all(std::move(tasks)));
+
+  IOL_CHECK((order == std::vector<int>{0, 1, 2, 3}));
+  IOL_CHECK(mutex.try_lock());
+  mutex.unlock();
+}
@@ -0,0 +1,170 @@
+#include "test.hpp"
+
+#include <iol/awaitable.hpp>
+#include <iol/sync_wait.hpp>
+
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+
+namespace local
+{
+
+iol::awaitable<int> leaf(int i)
+{
+  co_return i;
+}
+
+iol::awaitable<std::size_t> chain_allocations(int n)
+{
+  int sum = 0;
+  // warms up this thread's cache
+  for (int i = 0; i < 100; ++i)
+    sum += co_await leaf(i);
+
+  auto const before = iol_test::allocation_count();
+  for (int i = 0; i < n; ++i)
+    sum += co_await leaf(i);
+  co_return iol_test::allocation_count() - before + (sum < 0);
+}
+
+template <typename T>
+struct counting_allocator {
+
+  using value_type = T;
+
+  explicit counting_allocator(std::size_t* c) noexcept : count{c} {}
+
+  template <typename U>
+  counting_allocator(counting_allocator<U> const& other) noexcept : count{other.count}
+  {
+  }
+
+  T* allocate(std::size_t n)
+  {
+    ++*count;
+    return std::allocator<T>{}.allocate(n);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept
+  {
+    --*count;
+    std::allocator<T>{}.deallocate(p, n);
+  }
+
+  friend bool operator==(counting_allocator const&, counting_allocator const&) = default;
+
+  std::size_t* count;
+};
+
+iol::awaitable<int> allocated_through(
+    std::allocator_arg_t, counting_allocator<std::byte> allocator, std::size_t& live)
+{
+  live = *allocator.count;
+  co_return 42;
+}
+
+iol::awaitable<long> deep_chain(int depth)
+{
+  if (depth == 0)
+    co_return 0;
+  co_return co_await deep_chain(depth - 1) + 1;
+}
+
+// blocks inside a coroutine on work that completes on this very thread
+iol::awaitable<int> nested_sync_wait()
+{
+  co_return iol::sync_wait(leaf(1)) + 1;
+}
+
+iol::awaitable<int> awaits_nested_sync_wait()
+{
+  co_return co_await nested_sync_wait();
+}
+
+#if !IOL_SYMMETRIC_TRANSFER
+
+// lets its exception escape resume()
+struct throwing_coroutine {
+
+  struct promise_type {
+
+    throwing_coroutine get_return_object()
+    {
+      return {std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    void return_void() noexcept {}
+
+    [[noreturn]] void unhandled_exception() { throw; }
+  };
+
+  std::coroutine_handle<promise_type> handle;
+};
+
+throwing_coroutine throws()
+{
+  throw std::runtime_error{"thrown"};
+  co_return;
+}
+
+#endif
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(awaitable_frames_come_from_the_thread_cache)
+{
+  IOL_CHECK(iol::sync_wait(local::chain_allocations(10000)) == 0);
+}
+
+IOL_TEST(awaitable_frames_go_through_an_allocator_arg)
+{
+  std::size_t outstanding = 0;
+  std::size_t live = 0;
+  auto        result = iol::sync_wait(local::allocated_through(
+      std::allocator_arg, local::counting_allocator<std::byte>{&outstanding}, live));
+  IOL_CHECK(result == 42);
+  IOL_CHECK(live == 1);
+  IOL_CHECK(outstanding == 0);
+}
+
+IOL_TEST(awaitable_million_deep_chain_keeps_the_stack_flat)
+{
+  IOL_CHECK(iol::sync_wait(local::deep_chain(1000000)) == 1000000);
+}
+
+IOL_TEST(awaitable_sync_wait_inside_a_coroutine_completes)
+{
+  IOL_CHECK(iol::sync_wait(local::awaits_nested_sync_wait()) == 2);
+}
+
+#if !IOL_SYMMETRIC_TRANSFER
+
+IOL_TEST(trampoline_recovers_from_an_exception)
+{
+  auto coroutine = local::throws();
+  bool caught = false;
+  try {
+    iol::detail::trampoline::transfer(std::noop_coroutine(), coroutine.handle);
+  } catch (std::runtime_error const&) {
+    caught = true;
+  }
+  coroutine.handle.destroy();
+
+  IOL_CHECK(caught);
+  // the thread's trampoline is usable again
+  IOL_CHECK(iol::sync_wait(local::awaits_nested_sync_wait()) == 2);
+  IOL_CHECK(iol::sync_wait(local::deep_chain(1000)) == 1000);
+}
+
+#endif
@@ -0,0 +1,34 @@
+#include "test.hpp"
+
+#include <iol/detail/cpu_topology.hpp>
+#include <iol/static_thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+
+IOL_TEST(cpu_topology_lists_the_cpu_we_run_on)
+{
+  auto const cpus = iol::detail::available_cpus();
+  auto const current = iol::detail::current_cpu();
+  if (cpus.empty() || current < 0)
+    return;
+
+  IOL_CHECK(std::ranges::is_sorted(cpus, {}, &iol::detail::cpu_info::id));
+  IOL_CHECK(std::ranges::any_of(cpus, [&](auto const& cpu) { return cpu.id == current; }));
+  IOL_CHECK(std::ranges::all_of(cpus, [](auto const& cpu) { return cpu.node >= 0; }));
+}
+
+IOL_TEST(static_thread_pool_runs_with_every_placement)
+{
+  using placement = iol::static_thread_pool::thread_placement;
+
+  for (auto where : {placement::none, placement::cpu_set, placement::spread_cores,
+                     placement::spread_nodes}) {
+    iol::static_thread_pool pool{2, {.placement = where}};
+    std::atomic_int         ran{0};
+    for (int i = 0; i < 100; ++i)
+      pool.post([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+    pool.wait();
+    IOL_CHECK(ran.load() == 100);
+  }
+}
@@ -0,0 +1,148 @@
+#include "test.hpp"
+
+#include <iol/detail/fast_mutex.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using iol::detail::fast_mutex;
+
+constexpr std::size_t threads = 4;
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(fast_mutex_excludes_under_contention)
+{
+  constexpr std::size_t per_thread = 50000;
+
+  local::fast_mutex mutex;
+  std::size_t       counter = 0;
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < local::threads; ++t)
+    workers.emplace_back(
+        [&, t]
+        {
+          for (std::size_t i = 0; i < per_thread; ++i) {
+            // mixes in try_lock so both ways in race against the unlock path
+            if ((i + t) % 4 == 0 && mutex.try_lock()) {
+              ++counter;
+              mutex.unlock();
+              continue;
+            }
+            local::fast_mutex::scoped_lock lock{mutex};
+            ++counter;
+          }
+        });
+  for (auto& w : workers)
+    w.join();
+
+  IOL_CHECK(counter == local::threads * per_thread);
+  IOL_CHECK(mutex.try_lock());
+  mutex.unlock();
+}
+
+IOL_TEST(fast_mutex_cond_var_passes_every_item)
+{
+  constexpr std::size_t per_producer = 20000;
+  constexpr std::size_t capacity = 8;
+
+  local::fast_mutex           mutex;
+  local::fast_mutex::cond_var cv;
+  std::vector<std::size_t>    queue;
+  std::size_t                 consumed = 0;
+  std::size_t                 sum = 0;
+
+  auto const total = local::threads / 2 * per_producer;
+
+  std::vector<std::thread> workers;
+  for (std::size_t t = 0; t < local::threads / 2; ++t) {
+    workers.emplace_back(
+        [&]
+        {
+          for (std::size_t i = 0; i < per_producer; ++i) {
+            local::fast_mutex::scoped_lock lock{mutex};
+            cv.wait(lock, [&] { return queue.size() < capacity; });
+            queue.push_back(i);
+            // producers and consumers share the cond_var, a single wake up could hit the
+            // wrong side
+            cv.notify_all();
+          }
+        });
+    workers.emplace_back(
+        [&]
+        {
+          while (true) {
+            local::fast_mutex::scoped_lock lock{mutex};
+            cv.wait(lock, [&] { return !queue.empty() || consumed == total; });
+            if (consumed == total)
+              return;
+            sum += queue.back();
+            queue.pop_back();
+            if (++consumed == total || queue.size() == capacity - 1)
+              cv.notify_all();
+          }
+        });
+  }
+  for (auto& w : workers)
+    w.join();
+
+  IOL_CHECK(consumed == total);
+  IOL_CHECK(sum == local::threads / 2 * (per_producer * (per_producer - 1) / 2));
+}
+
+IOL_TEST(fast_mutex_cond_var_notify_one_wakes_each_waiter)
+{
+  local::fast_mutex           mutex;
+  local::fast_mutex::cond_var cv;
+  std::size_t                 tokens = 0;
+  std::size_t                 woken = 0;
+
+  std::vector<std::thread> waiters;
+  for (std::size_t t = 0; t < local::threads; ++t)
+    waiters.emplace_back(
+        [&]
+        {
+          local::fast_mutex::scoped_lock lock{mutex};
+          cv.wait(lock, [&] { return tokens > 0; });
+          --tokens;
+          ++woken;
+        });
+
+  for (std::size_t t = 0; t < local::threads; ++t) {
+    local::fast_mutex::scoped_lock lock{mutex};
+    ++tokens;
+    cv.notify_one();
+  }
+  for (auto& w : waiters)
+    w.join();
+
+  IOL_CHECK(woken == local::threads);
+  IOL_CHECK(tokens == 0);
+}
+
+IOL_TEST(fast_mutex_cond_var_wait_for_times_out)
+{
+  using namespace std::chrono_literals;
+
+  local::fast_mutex              mutex;
+  local::fast_mutex::cond_var    cv;
+  local::fast_mutex::scoped_lock lock{mutex};
+
+  auto const start = std::chrono::steady_clock::now();
+  IOL_CHECK(!cv.wait_for(lock, 20ms, [] { return false; }));
+  IOL_CHECK(std::chrono::steady_clock::now() - start >= 20ms);
+
+  // the mutex is held again after the timeout
+  IOL_CHECK(!mutex.try_lock());
+}
@@ -0,0 +1,218 @@
+#include "test.hpp"
+
+#include <iol/awaitable.hpp>
+#include <iol/generator.hpp>
+#include <iol/sync_wait.hpp>
+
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+iol::generator<int> throws_after(int n)
+{
+  for (int i = 0; i < n; ++i)
+    co_yield i;
+  throw std::runtime_error{"generator"};
+}
+
+iol::generator<int> nests(int depth, int n)
+{
+  if (depth == 0)
+    co_yield iol::elements_of(throws_after(n));
+  else
+    co_yield iol::elements_of(nests(depth - 1, n));
+}
+
+iol::generator<int> catches_nested()
+{
+  bool caught = false;
+  try {
+    co_yield iol::elements_of(throws_after(2));
+  } catch (std::runtime_error const&) {
+    caught = true;
+  }
+  co_yield caught ? -1 : 0;
+  co_yield 10;
+}
+
+struct destroy_flag {
+
+  explicit destroy_flag(bool& f) noexcept : flag{&f} {}
+
+  destroy_flag(destroy_flag&& other) noexcept : flag{std::exchange(other.flag, nullptr)} {}
+
+  ~destroy_flag()
+  {
+    if (flag)
+      *flag = true;
+  }
+
+  bool* flag;
+};
+
+// the parameter lives in the frame until it is destroyed
+iol::generator<int> tracked(destroy_flag, int n)
+{
+  for (int i = 0; i < n; ++i)
+    co_yield i;
+}
+
+iol::generator<int> borrows(iol::generator<int>& source)
+{
+  co_yield iol::elements_of(source);
+  co_yield 10;
+}
+
+iol::generator<int> takes(iol::generator<int>&& source)
+{
+  co_yield iol::elements_of(std::move(source));
+  co_yield 10;
+}
+
+iol::generator<int> count_to(int n)
+{
+  for (int i = 0; i < n; ++i)
+    co_yield i;
+}
+
+iol::owning_generator<std::unique_ptr<int>> boxes(int n)
+{
+  for (int i = 0; i < n; ++i)
+    co_yield std::make_unique<int>(i);
+}
+
+// each string is a temporary that is gone by the next statement
+iol::owning_generator<std::string> temporaries(int n)
+{
+  for (int i = 0; i < n; ++i)
+    co_yield std::string(40, static_cast<char>('a' + i));
+}
+
+iol::awaitable<int> leaf()
+{
+  co_return 1;
+}
+
+}  // namespace local
+
+}  // namespace
+
+static_assert(std::ranges::input_range<iol::generator<int>>);
+static_assert(std::ranges::view<iol::generator<int>>);
+static_assert(std::ranges::input_range<iol::owning_generator<std::unique_ptr<int>>>);
+
+IOL_TEST(generator_rethrows_a_nested_exception_to_the_consumer)
+{
+  std::vector<int> seen;
+  bool             thrown = false;
+  auto             gen = local::nests(3, 2);
+  try {
+    for (auto i : gen)
+      seen.push_back(i);
+  } catch (std::runtime_error const&) {
+    thrown = true;
+  }
+  IOL_CHECK(thrown);
+  IOL_CHECK((seen == std::vector<int>{0, 1}));
+
+  // nothing was left half transferred
+  IOL_CHECK(iol::sync_wait(local::leaf()) == 1);
+  std::vector<int> again;
+  for (auto i : local::catches_nested())
+    again.push_back(i);
+  IOL_CHECK((again == std::vector<int>{0, 1, -1, 10}));
+}
+
+IOL_TEST(generator_rethrows_from_begin)
+{
+  bool thrown = false;
+  auto gen = local::nests(2, 0);
+  try {
+    (void)gen.begin();
+  } catch (std::runtime_error const&) {
+    thrown = true;
+  }
+  IOL_CHECK(thrown);
+  IOL_CHECK(gen.begin() == std::default_sentinel);
+}
+
+IOL_TEST(generator_lets_the_parent_catch_at_the_co_yield)
+{
+  std::vector<int> seen;
+  for (auto i : local::catches_nested())
+    seen.push_back(i);
+  IOL_CHECK((seen == std::vector<int>{0, 1, -1, 10}));
+}
+
+IOL_TEST(generator_iterates_an_lvalue_generator_without_taking_it)
+{
+  bool destroyed = false;
+  auto source = local::tracked(local::destroy_flag{destroyed}, 3);
+
+  std::vector<int> seen;
+  for (auto i : local::borrows(source))
+    seen.push_back(i);
+  IOL_CHECK((seen == std::vector<int>{0, 1, 2, 10}));
+  // still owned here
+  IOL_CHECK(!destroyed);
+  IOL_CHECK(source.begin() == std::default_sentinel);
+  source = {};
+  IOL_CHECK(destroyed);
+}
+
+IOL_TEST(generator_takes_over_an_rvalue_generator)
+{
+  bool destroyed = false;
+  auto source = local::tracked(local::destroy_flag{destroyed}, 3);
+
+  std::vector<int> seen;
+  {
+    auto gen = local::takes(std::move(source));
+    for (auto i : gen) {
+      seen.push_back(i);
+      // the nested generator goes once it is done
+      if (i == 10)
+        IOL_CHECK(destroyed);
+    }
+  }
+  IOL_CHECK((seen == std::vector<int>{0, 1, 2, 10}));
+  IOL_CHECK(destroyed);
+}
+
+IOL_TEST(owning_generator_moves_values_out_through_the_iterator)
+{
+  std::vector<std::unique_ptr<int>> taken;
+  auto                              gen = local::boxes(3);
+  for (auto it = gen.begin(); it != gen.end(); ++it)
+    taken.push_back(*it);
+  IOL_CHECK(taken.size() == 3);
+  for (int i = 0; i < 3; ++i)
+    IOL_CHECK(taken[i] && *taken[i] == i);
+}
+
+IOL_TEST(owning_generator_keeps_yielded_temporaries)
+{
+  std::vector<std::string> seen;
+  for (auto const& s : local::temporaries(3))
+    seen.push_back(s);
+  IOL_CHECK((seen == std::vector<std::string>{
+                 std::string(40, 'a'), std::string(40, 'b'), std::string(40, 'c')}));
+}
+
+IOL_TEST(generator_composes_with_views)
+{
+  std::vector<int> seen;
+  for (auto i : local::count_to(100) | std::views::filter([](int i) { return i % 3 == 0; }) |
+                    std::views::transform([](int i) { return i * 2; }) | std::views::take(4))
+    seen.push_back(i);
+  IOL_CHECK((seen == std::vector<int>{0, 6, 12, 18}));
+}
@@ -10,6 +10,8 @@
 #include <iol/execution/sender.hpp>
 #include <iol/meta.hpp>
 
+#include "test.hpp"
+
 template <typename T>
 constexpr auto type_name() -> std::string_view
 {
@@ -92,5 +94,5 @@ int main(int argc, char* argv[])
 
   sync_wait(std::move(v));
 
-  return 0;
+  return iol_test::run(argc > 1 ? argv[1] : nullptr) ? 1 : 0;
 }
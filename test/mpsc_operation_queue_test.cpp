@@ -0,0 +1,152 @@
+#include "test.hpp"
+
+#include <iol/detail/mpsc_operation_queue.hpp>
+#include <iol/detail/operation_queue.hpp>
+#include <iol/detail/work_stealing_deque.hpp>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+struct tagged_operation : detail::operation_base {
+
+  tagged_operation(std::size_t p, std::size_t s)
+    : detail::operation_base{[](void*, detail::operation_base*) {}, nullptr}, producer{p}, seq{s}
+  {
+  }
+
+  std::size_t producer;
+  std::size_t seq;
+};
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(mpsc_operation_queue_keeps_producer_order)
+{
+  using namespace local;
+
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t per_producer = 50000;
+
+  std::vector<std::vector<tagged_operation>> ops(producers);
+  for (std::size_t p = 0; p < producers; ++p) {
+    ops[p].reserve(per_producer);
+    for (std::size_t s = 0; s < per_producer; ++s)
+      ops[p].emplace_back(p, s);
+  }
+
+  detail::mpsc_operation_queue queue;
+  std::vector<std::thread>     threads;
+  for (std::size_t p = 0; p < producers; ++p)
+    threads.emplace_back(
+        [&, p]
+        {
+          // every other operation goes in as part of a two element batch
+          for (std::size_t s = 0; s < per_producer; ++s) {
+            if (s % 4 == 2 && s + 1 < per_producer) {
+              detail::operation_queue batch;
+              batch.enqueue(detail::operation_ptr{&ops[p][s]});
+              batch.enqueue(detail::operation_ptr{&ops[p][s + 1]});
+              queue.enqueue(std::move(batch));
+              ++s;
+            } else {
+              queue.enqueue(detail::operation_ptr{&ops[p][s]});
+            }
+          }
+        });
+
+  std::vector<std::size_t> next(producers, 0);
+  std::size_t              received = 0;
+  bool                     in_order = true;
+
+  auto const check = [&](detail::operation_base* base)
+  {
+    auto* op = static_cast<tagged_operation*>(base);
+    in_order &= op->seq == next[op->producer]++;
+    ++received;
+  };
+
+  while (received < producers * per_producer) {
+    if (received % 3 == 0) {
+      detail::operation_queue batch;
+      queue.try_deque(batch, 16);
+      while (!batch.empty())
+        check(batch.deque().release());
+    } else if (auto op = queue.try_deque()) {
+      check(op.release());
+    }
+  }
+
+  for (auto& t : threads)
+    t.join();
+
+  IOL_CHECK(in_order);
+  IOL_CHECK(queue.empty());
+  IOL_CHECK(!queue.try_deque());
+}
+
+IOL_TEST(work_stealing_deque_hands_out_each_operation_once)
+{
+  using namespace local;
+
+  constexpr std::size_t count = 100000;
+  constexpr std::size_t thieves = 3;
+
+  std::vector<tagged_operation> ops;
+  ops.reserve(count);
+  for (std::size_t s = 0; s < count; ++s)
+    ops.emplace_back(0, s);
+
+  // starts small so it grows while thieves are reading
+  detail::work_stealing_deque  deque{4};
+  std::vector<std::atomic_int> seen(count);
+  std::atomic_size_t           taken{0};
+  std::vector<std::thread>     threads;
+
+  auto const take = [&](detail::operation_base* base)
+  {
+    seen[static_cast<tagged_operation*>(base)->seq].fetch_add(1, std::memory_order_relaxed);
+    taken.fetch_add(1, std::memory_order_relaxed);
+  };
+
+  for (std::size_t t = 0; t < thieves; ++t)
+    threads.emplace_back(
+        [&]
+        {
+          while (taken.load(std::memory_order_relaxed) < count) {
+            if (auto op = deque.steal())
+              take(op.release());
+            else
+              std::this_thread::yield();
+          }
+        });
+
+  for (std::size_t s = 0; s < count; ++s) {
+    deque.push(detail::operation_ptr{&ops[s]});
+    if (s % 3 == 0)
+      if (auto op = deque.pop())
+        take(op.release());
+  }
+  while (auto op = deque.pop())
+    take(op.release());
+
+  for (auto& t : threads)
+    t.join();
+
+  bool once = true;
+  for (auto& n : seen)
+    once &= n.load() == 1;
+  IOL_CHECK(once);
+  IOL_CHECK(deque.empty());
+}
@@ -0,0 +1,85 @@
+#include "test.hpp"
+
+#include <iol/execution/run_loop.hpp>
+#include <iol/execution/sender.hpp>
+#include <iol/execution/sync_wait.hpp>
+#include <iol/static_thread_pool.hpp>
+
+#include <deque>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol::execution;
+
+struct record_receiver {
+  std::vector<int>* order;
+  int               id;
+
+  friend void tag_invoke(set_value_t, record_receiver&& r) noexcept { r.order->push_back(r.id); }
+
+  friend void tag_invoke(set_error_t, record_receiver&&, std::exception_ptr) noexcept {}
+
+  friend void tag_invoke(set_stopped_t, record_receiver&&) noexcept {}
+};
+
+using scheduler_type = decltype(std::declval<run_loop&>().get_scheduler());
+
+using op_type = connect_result_t<schedule_result_t<scheduler_type>, record_receiver>;
+
+// operation states can't move, the deque keeps them in place
+struct started {
+  started(run_loop& loop, std::vector<int>& order, int id)
+    : op{connect(schedule(loop.get_scheduler()), record_receiver{&order, id})}
+  {
+    start(op);
+  }
+
+  op_type op;
+};
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(run_loop_keeps_push_order_across_poll_one_and_poll)
+{
+  iol::execution::run_loop   loop;
+  std::vector<int>           order;
+  std::deque<local::started> ops;
+
+  for (int id = 1; id <= 3; ++id)
+    ops.emplace_back(loop, order, id);
+  IOL_CHECK(loop.poll_one());
+  // 2 and 3 are left behind in the loop's own queue
+  ops.emplace_back(loop, order, 4);
+  IOL_CHECK(loop.poll() == 3);
+  IOL_CHECK((order == std::vector<int>{1, 2, 3, 4}));
+
+  for (int id = 5; id <= 7; ++id)
+    ops.emplace_back(loop, order, id);
+  IOL_CHECK(loop.run_one());
+  ops.emplace_back(loop, order, 8);
+  IOL_CHECK(loop.poll_one());
+  ops.emplace_back(loop, order, 9);
+  IOL_CHECK(loop.run_until_idle() == 3);
+  IOL_CHECK((order == std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+  IOL_CHECK(!loop.poll_one());
+  loop.finish();
+  loop.run();
+}
+
+IOL_TEST(run_loop_outlives_a_push_from_another_thread)
+{
+  iol::static_thread_pool pool{1};
+  // finish() from the pool thread wakes the loop, sync_wait destroys it right after
+  for (int i = 0; i < 20000; ++i)
+    IOL_CHECK(iol::execution::sync_wait(iol::execution::schedule(pool.get_scheduler())));
+}
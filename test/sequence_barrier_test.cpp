@@ -0,0 +1,88 @@
+#include "test.hpp"
+
+#include <iol/awaitable.hpp>
+#include <iol/sequence_barrier.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+#include <iol/when_all.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+constexpr std::size_t last = 20000;
+
+awaitable<void> follow(
+    static_thread_pool& pool, sequence_barrier& barrier, std::size_t step, std::atomic_bool& ok)
+{
+  co_await pool.schedule();
+  for (std::size_t target = 0; target <= last; target += step)
+    if (co_await barrier.wait_until_published(target) < target)
+      ok.store(false, std::memory_order_relaxed);
+}
+
+awaitable<void> wait_for_one(sequence_barrier& barrier, std::size_t& seen)
+{
+  seen = co_await barrier.wait_until_published(1);
+}
+
+awaitable<void> publish_across_zero(sequence_barrier& barrier, std::size_t const& seen)
+{
+  // -1 comes before 1 even though it is the larger number
+  barrier.publish(static_cast<std::size_t>(-1));
+  IOL_CHECK(seen == 0);
+  barrier.publish(2);
+  co_return;
+}
+
+awaitable<void> all(std::vector<awaitable<void>> tasks)
+{
+  co_await when_all(std::move(tasks));
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(sequence_barrier_resumes_waiters_racing_the_publisher)
+{
+  iol::static_thread_pool pool{4};
+  iol::sequence_barrier   barrier;
+  std::atomic_bool        ok{true};
+
+  std::vector<iol::awaitable<void>> followers;
+  for (std::size_t step = 1; step <= 4; ++step)
+    followers.push_back(local::follow(pool, barrier, step, ok));
+
+  std::thread publisher{[&]
+                        {
+                          for (std::size_t sequence = 0; sequence <= local::last; ++sequence)
+                            barrier.publish(sequence);
+                        }};
+  iol::sync_wait(local::all(std::move(followers)));
+  publisher.join();
+
+  IOL_CHECK(ok.load());
+  IOL_CHECK(barrier.last_published() == local::last);
+}
+
+IOL_TEST(sequence_barrier_compares_wrapping_sequences)
+{
+  iol::sequence_barrier barrier{static_cast<std::size_t>(-3)};
+  std::size_t           seen = 0;
+
+  std::vector<iol::awaitable<void>> tasks;
+  tasks.push_back(local::wait_for_one(barrier, seen));
+  tasks.push_back(local::publish_across_zero(barrier, seen));
+  iol::sync_wait(local::all(std::move(tasks)));
+  IOL_CHECK(seen == 2);
+}
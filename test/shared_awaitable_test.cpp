@@ -0,0 +1,205 @@
+#include "test.hpp"
+
+#include <iol/async_manual_reset_event.hpp>
+#include <iol/awaitable.hpp>
+#include <iol/shared_awaitable.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+#include <iol/when_all.hpp>
+
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+shared_awaitable<int> gated_value(async_manual_reset_event& gate, int& runs)
+{
+  ++runs;
+  co_await gate;
+  co_return 42;
+}
+
+shared_awaitable<int> value_on(static_thread_pool& pool)
+{
+  co_await pool.schedule();
+  co_return 42;
+}
+
+awaitable<void> take(shared_awaitable<int> shared, std::vector<int>& seen)
+{
+  seen.push_back(co_await shared);
+}
+
+awaitable<void> take_on(
+    static_thread_pool& pool, shared_awaitable<int> shared, std::atomic_int& sum)
+{
+  co_await pool.schedule();
+  sum.fetch_add(co_await shared, std::memory_order_relaxed);
+}
+
+awaitable<void> record_thread(shared_awaitable<int> shared, std::vector<std::thread::id>& ids)
+{
+  co_await shared;
+  ids.push_back(std::this_thread::get_id());
+}
+
+awaitable<void> open(async_manual_reset_event& gate, shared_awaitable<int> shared)
+{
+  // every other task is waiting on the shared result by now
+  IOL_CHECK(!shared.is_ready());
+  gate.set();
+  co_return;
+}
+
+awaitable<void> all(std::vector<awaitable<void>> tasks)
+{
+  co_await when_all(std::move(tasks));
+}
+
+struct destroy_flag {
+
+  explicit destroy_flag(bool& f) noexcept : flag{&f} {}
+
+  destroy_flag(destroy_flag&& other) noexcept : flag{std::exchange(other.flag, nullptr)} {}
+
+  ~destroy_flag()
+  {
+    if (flag)
+      *flag = true;
+  }
+
+  bool* flag;
+};
+
+// the parameter lives in the frame until it is destroyed
+shared_awaitable<int> tracked(destroy_flag)
+{
+  co_return 7;
+}
+
+struct counting_executor {
+
+  template <typename Function>
+  void post(Function&& function)
+  {
+    posts.fetch_add(1, std::memory_order_relaxed);
+    pool->post(std::forward<Function>(function));
+  }
+
+  static_thread_pool* pool;
+  std::atomic_int     posts{0};
+};
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(shared_awaitable_gives_every_waiter_the_value)
+{
+  iol::async_manual_reset_event gate;
+  int                           runs = 0;
+  std::vector<int>              seen;
+  auto                          shared = local::gated_value(gate, runs);
+
+  std::vector<iol::awaitable<void>> tasks;
+  for (int i = 0; i < 4; ++i)
+    tasks.push_back(local::take(shared, seen));
+  tasks.push_back(local::open(gate, shared));
+  iol::sync_wait(local::all(std::move(tasks)));
+
+  IOL_CHECK(runs == 1);
+  IOL_CHECK((seen == std::vector<int>{42, 42, 42, 42}));
+}
+
+IOL_TEST(shared_awaitable_gives_concurrent_waiters_the_value)
+{
+  constexpr int waiters = 64;
+
+  iol::static_thread_pool pool{4};
+  for (int round = 0; round < 100; ++round) {
+    std::atomic_int sum{0};
+    auto            shared = local::value_on(pool);
+
+    std::vector<iol::awaitable<void>> tasks;
+    for (int i = 0; i < waiters; ++i)
+      tasks.push_back(local::take_on(pool, shared, sum));
+    iol::sync_wait(local::all(std::move(tasks)));
+    IOL_CHECK(sum.load() == waiters * 42);
+  }
+}
+
+IOL_TEST(shared_awaitable_completes_awaits_after_the_result)
+{
+  iol::async_manual_reset_event gate{true};
+  int                           runs = 0;
+  std::vector<int>              seen;
+  auto                          shared = local::gated_value(gate, runs);
+
+  iol::sync_wait(local::take(shared, seen));
+  IOL_CHECK(shared.is_ready());
+  iol::sync_wait(local::take(shared, seen));
+  iol::sync_wait(local::take(shared, seen));
+
+  IOL_CHECK(runs == 1);
+  IOL_CHECK((seen == std::vector<int>{42, 42, 42}));
+}
+
+IOL_TEST(shared_awaitable_last_copy_destroys_the_frame)
+{
+  bool             destroyed = false;
+  std::vector<int> seen;
+  {
+    auto shared = local::tracked(local::destroy_flag{destroyed});
+    {
+      auto copy = shared;
+      auto other = copy;
+      iol::sync_wait(local::take(other, seen));
+    }
+    IOL_CHECK(!destroyed);
+    auto moved = std::move(shared);
+    IOL_CHECK(!destroyed);
+    shared = moved;
+    moved = {};
+    IOL_CHECK(!destroyed);
+  }
+  IOL_CHECK(destroyed);
+  IOL_CHECK((seen == std::vector<int>{7}));
+
+  // never started
+  destroyed = false;
+  {
+    auto shared = local::tracked(local::destroy_flag{destroyed});
+  }
+  IOL_CHECK(destroyed);
+}
+
+IOL_TEST(shared_awaitable_resume_on_posts_the_waiters)
+{
+  iol::static_thread_pool       pool{1};
+  local::counting_executor      executor{&pool};
+  iol::async_manual_reset_event gate;
+  int                           runs = 0;
+  auto                          shared = local::gated_value(gate, runs);
+  shared.resume_on(executor);
+
+  std::vector<std::thread::id>      ids;
+  std::vector<iol::awaitable<void>> tasks;
+  for (int i = 0; i < 3; ++i)
+    tasks.push_back(local::record_thread(shared, ids));
+  // sets the gate on this thread, the waiters go through the executor
+  tasks.push_back(local::open(gate, shared));
+  iol::sync_wait(local::all(std::move(tasks)));
+
+  IOL_CHECK(executor.posts.load() == 3);
+  IOL_CHECK(ids.size() == 3);
+  for (auto id : ids)
+    IOL_CHECK(id != std::this_thread::get_id());
+}
@@ -0,0 +1,62 @@
+#include "test.hpp"
+
+#include <iol/detail/simple_manual_reset_event.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+IOL_TEST(simple_manual_reset_event_wakes_waiters_racing_set)
+{
+  constexpr std::size_t rounds = 300;
+
+  iol::detail::simple_manual_reset_event event;
+  std::atomic_size_t                     woken{0};
+
+  for (std::size_t round = 0; round < rounds; ++round) {
+    std::vector<std::thread> waiters;
+    // sleeping and spinning waiters, set() lands before, during or after they go to sleep
+    for (std::size_t spin_count : {std::size_t{0}, std::size_t{0}, std::size_t{1000}})
+      waiters.emplace_back(
+          [&, spin_count]
+          {
+            event.wait(spin_count);
+            woken.fetch_add(1, std::memory_order_relaxed);
+          });
+    if (round % 2)
+      std::this_thread::yield();
+    event.set();
+    for (auto& w : waiters)
+      w.join();
+
+    IOL_CHECK(event.is_set());
+    event.reset();
+    IOL_CHECK(!event.is_set());
+  }
+  IOL_CHECK(woken.load() == 3 * rounds);
+}
+
+IOL_TEST(simple_manual_reset_event_stays_set_until_reset)
+{
+  iol::detail::simple_manual_reset_event event;
+  IOL_CHECK(!event.is_set());
+
+  // no effect while not set
+  event.reset();
+  IOL_CHECK(!event.is_set());
+
+  event.set();
+  event.set();
+  event.wait();
+  event.wait(10);
+  IOL_CHECK(event.is_set());
+
+  event.reset();
+  IOL_CHECK(!event.is_set());
+
+  std::thread waiter{[&] { event.wait(); }};
+  event.set();
+  waiter.join();
+  IOL_CHECK(event.is_set());
+}
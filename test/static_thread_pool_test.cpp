@@ -0,0 +1,343 @@
+#include "test.hpp"
+
+#include <iol/awaitable.hpp>
+#include <iol/execution/sync_wait.hpp>
+#include <iol/execution/then.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+#include <iol/when_all.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+/*
+ * External threads post, every operation defers another one onto the pool, the pool has to
+ * run every last one of them before wait() returns.
+ * */
+void post_stress(static_thread_pool::options const& opts)
+{
+  constexpr std::size_t producers = 4;
+  constexpr std::size_t per_producer = 20000;
+
+  static_thread_pool pool{4, opts};
+  std::atomic_size_t ran{0};
+
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; ++p)
+    threads.emplace_back(
+        [&]
+        {
+          for (std::size_t i = 0; i < per_producer; ++i)
+            pool.post(
+                [&]
+                {
+                  ran.fetch_add(1, std::memory_order_relaxed);
+                  pool.defer([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+                });
+        });
+  for (auto& t : threads)
+    t.join();
+
+  pool.wait();
+  IOL_CHECK(ran.load() == 2 * producers * per_producer);
+}
+
+using clock_type = std::chrono::steady_clock;
+
+using timer_type = decltype(std::declval<static_thread_pool&>().schedule_after({}));
+
+struct fired_timer {
+  int                    id;
+  clock_type::time_point deadline;
+  clock_type::time_point fired;
+};
+
+awaitable<void> sleep_then_record(
+    static_thread_pool& pool, clock_type::duration delay, int id, std::vector<fired_timer>& fired)
+{
+  auto const deadline = clock_type::now() + delay;
+  co_await pool.schedule_after(delay);
+  fired.push_back({id, deadline, clock_type::now()});
+}
+
+awaitable<bool> cancellable_sleep(static_thread_pool& pool, std::atomic<timer_type*>& shared)
+{
+  auto timer = pool.schedule_after(std::chrono::seconds{30});
+  shared.store(&timer, std::memory_order_release);
+  co_return co_await timer;
+}
+
+awaitable<bool> cancel_after_firing(static_thread_pool& pool)
+{
+  auto timer = pool.schedule_after(std::chrono::milliseconds{1});
+  if (!co_await timer)
+    co_return false;
+  // nothing left to cancel
+  co_return !timer.cancel();
+}
+
+awaitable<void> all(std::vector<awaitable<void>> tasks)
+{
+  co_await when_all(std::move(tasks));
+}
+
+enum class completion { none, value, error, stopped };
+
+struct completion_receiver {
+  std::atomic<completion>* result;
+
+  friend void tag_invoke(execution::set_value_t, completion_receiver&& r) noexcept
+  {
+    r.result->store(completion::value);
+  }
+
+  friend void tag_invoke(
+      execution::set_error_t, completion_receiver&& r, std::exception_ptr) noexcept
+  {
+    r.result->store(completion::error);
+  }
+
+  friend void tag_invoke(execution::set_stopped_t, completion_receiver&& r) noexcept
+  {
+    r.result->store(completion::stopped);
+  }
+};
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(static_thread_pool_shared_queue_runs_every_post)
+{
+  local::post_stress({});
+}
+
+IOL_TEST(static_thread_pool_work_stealing_runs_every_post)
+{
+  local::post_stress({.mode = iol::static_thread_pool::scheduling_mode::work_stealing});
+}
+
+IOL_TEST(static_thread_pool_batched_claims_run_each_operation_once)
+{
+  constexpr std::size_t count = 40000;
+
+  iol::static_thread_pool      pool{3, {.batch_size = 8}};
+  std::vector<std::atomic_int> runs(count);
+
+  auto const run = [&](std::size_t i) { runs[i].fetch_add(1, std::memory_order_relaxed); };
+
+  std::thread producer{[&]
+                       {
+                         for (std::size_t i = 0; i < count / 2; ++i)
+                           pool.post([&, i] { run(i); });
+                       }};
+  pool.bulk_post(count / 2, [&](std::size_t i) { run(count / 2 + i); });
+  producer.join();
+
+  pool.wait();
+  bool once = true;
+  for (auto& n : runs)
+    once &= n.load() == 1;
+  IOL_CHECK(once);
+}
+
+IOL_TEST(static_thread_pool_spinning_workers_pick_up_bursts)
+{
+  iol::static_thread_pool pool{2, {.spin_count = 4000}};
+  std::atomic_size_t      ran{0};
+
+  // bursts land on workers that are spinning, then on ones that gave up and parked
+  for (std::size_t burst = 0; burst < 50; ++burst) {
+    for (std::size_t i = 0; i < 10; ++i)
+      pool.post([&] { ran.fetch_add(1, std::memory_order_relaxed); });
+    while (ran.load(std::memory_order_relaxed) != (burst + 1) * 10)
+      std::this_thread::yield();
+    if (burst % 10 == 9)
+      std::this_thread::sleep_for(std::chrono::milliseconds{2});
+  }
+
+  pool.wait();
+  IOL_CHECK(ran.load() == 500);
+}
+
+IOL_TEST(static_thread_pool_timers_fire_in_deadline_order_never_early)
+{
+  using namespace std::chrono_literals;
+
+  // one worker, the order they resume in is the order they were queued
+  iol::static_thread_pool           pool{1};
+  std::vector<local::fired_timer>   fired;
+  std::vector<iol::awaitable<void>> sleeps;
+
+  constexpr local::clock_type::duration delays[] = {40ms, 10ms, 70ms, 0ms, 25ms, 55ms};
+
+  for (int id = 0; id < 6; ++id)
+    sleeps.push_back(local::sleep_then_record(pool, delays[id], id, fired));
+  iol::sync_wait(local::all(std::move(sleeps)));
+
+  IOL_CHECK(fired.size() == 6);
+  std::vector<int> order;
+  bool             early = false;
+  for (auto const& timer : fired) {
+    order.push_back(timer.id);
+    early |= timer.fired < timer.deadline;
+  }
+  IOL_CHECK((order == std::vector<int>{3, 1, 4, 0, 5, 2}));
+  IOL_CHECK(!early);
+}
+
+IOL_TEST(static_thread_pool_cancelled_timer_resumes_early)
+{
+  iol::static_thread_pool         pool{2};
+  std::atomic<local::timer_type*> timer{nullptr};
+  bool                            not_cancelled = true;
+  auto const                      start = local::clock_type::now();
+
+  std::thread waiter{
+      [&] { not_cancelled = iol::sync_wait(local::cancellable_sleep(pool, timer)); }};
+
+  // cancel() is false until the coroutine got to wait on the timer
+  local::timer_type* op;
+  while (!(op = timer.load(std::memory_order_acquire)))
+    std::this_thread::yield();
+  while (!op->cancel())
+    std::this_thread::yield();
+  waiter.join();
+
+  IOL_CHECK(!not_cancelled);
+  IOL_CHECK(local::clock_type::now() - start < std::chrono::seconds{10});
+  IOL_CHECK(iol::sync_wait(local::cancel_after_firing(pool)));
+}
+
+IOL_TEST(static_thread_pool_timer_sender_waits_for_the_delay)
+{
+  using namespace std::chrono_literals;
+
+  iol::static_thread_pool pool{1};
+  auto const              start = local::clock_type::now();
+  auto const              result =
+      iol::execution::sync_wait(iol::execution::schedule_after(pool.get_scheduler(), 20ms));
+  IOL_CHECK(result.has_value());
+  IOL_CHECK(local::clock_type::now() - start >= 20ms);
+}
+
+IOL_TEST(static_thread_pool_wait_includes_timers)
+{
+  using namespace std::chrono_literals;
+
+  std::atomic<local::completion> fired{local::completion::none};
+  std::atomic<local::completion> dropped{local::completion::none};
+  {
+    iol::static_thread_pool pool{2};
+    auto                    sched = pool.get_scheduler();
+
+    auto short_timer = iol::execution::connect(
+        iol::execution::schedule_after(sched, 20ms), local::completion_receiver{&fired});
+    iol::execution::start(short_timer);
+    pool.wait();
+    IOL_CHECK(fired.load() == local::completion::value);
+
+    // still pending when the pool goes away
+    auto long_timer = iol::execution::connect(
+        iol::execution::schedule_after(sched, 30s), local::completion_receiver{&dropped});
+    iol::execution::start(long_timer);
+  }
+  IOL_CHECK(dropped.load() == local::completion::stopped);
+}
+
+IOL_TEST(static_thread_pool_shared_queue_starts_operations_in_order)
+{
+  iol::static_thread_pool pool{1};
+  std::vector<int>        order;
+
+  for (int i = 0; i < 5; ++i)
+    pool.post([&, i] { order.push_back(i); });
+  pool.post(
+      [&]
+      {
+        for (int i = 5; i < 10; ++i)
+          pool.post([&, i] { order.push_back(i); });
+        for (int i = 10; i < 15; ++i)
+          pool.defer([&, i] { order.push_back(i); });
+      });
+  pool.wait();
+
+  std::vector<int> expected;
+  for (int i = 0; i < 15; ++i)
+    expected.push_back(i);
+  IOL_CHECK(order == expected);
+}
+
+IOL_TEST(static_thread_pool_bulk_post_runs_every_item_once)
+{
+  constexpr std::size_t count = 10000;
+
+  iol::static_thread_pool      pool{3};
+  std::vector<std::atomic_int> by_count(count);
+  std::vector<std::atomic_int> by_value(count);
+  std::vector<std::size_t>     values;
+  for (std::size_t i = 0; i < count; ++i)
+    values.push_back(i);
+
+  pool.bulk_post(count, [&](std::size_t i) { by_count[i].fetch_add(1); });
+  pool.bulk_post(values, [&](std::size_t v) { by_value[v].fetch_add(1); });
+  // from inside the pool and over a view, nothing is queued for an empty one
+  pool.post(
+      [&]
+      {
+        pool.bulk_post(
+            std::views::iota(std::size_t{0}, count),
+            [&](std::size_t v) { by_value[v].fetch_add(1); });
+        pool.bulk_post(0, [&](std::size_t) { by_count[0].fetch_add(1); });
+      });
+  pool.wait();
+
+  bool once = true;
+  for (std::size_t i = 0; i < count; ++i)
+    once &= by_count[i].load() == 1 && by_value[i].load() == 2;
+  IOL_CHECK(once);
+}
+
+IOL_TEST(static_thread_pool_scheduler_completes_on_the_pool)
+{
+  iol::static_thread_pool pool{2};
+  auto const              sched = pool.get_scheduler();
+
+  auto const on_pool = iol::execution::sync_wait(
+      iol::execution::schedule(sched) |
+      iol::execution::then([&] { return pool.running_in_this_thread(); }));
+  IOL_CHECK(on_pool.has_value());
+  IOL_CHECK(std::get<0>(*on_pool));
+  IOL_CHECK(!pool.running_in_this_thread());
+}
+
+IOL_TEST(static_thread_pool_scheduler_stops_operations_left_queued)
+{
+  std::atomic<local::completion> result{local::completion::none};
+  {
+    iol::static_thread_pool pool{1};
+    pool.stop();
+    pool.wait();
+
+    // no worker is left to run it, destroying the pool completes it
+    auto op = iol::execution::connect(
+        iol::execution::schedule(pool.get_scheduler()), local::completion_receiver{&result});
+    iol::execution::start(op);
+    IOL_CHECK(result.load() == local::completion::none);
+  }
+  IOL_CHECK(result.load() == local::completion::stopped);
+}
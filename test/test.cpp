@@ -0,0 +1,98 @@
+#include "test.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <string>
+
+namespace
+{
+
+namespace local
+{
+
+struct check_failure : std::exception {
+  explicit check_failure(std::string msg) : message{std::move(msg)} {}
+
+  char const* what() const noexcept override { return message.c_str(); }
+
+  std::string message;
+};
+
+std::atomic_size_t allocations{0};
+
+}  // namespace local
+
+}  // namespace
+
+// counts every allocation the test binary makes
+void* operator new(std::size_t size)
+{
+  local::allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+  local::allocations.fetch_add(1, std::memory_order_relaxed);
+  auto const alignment = static_cast<std::size_t>(align);
+  if (auto* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    return p;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace iol_test
+{
+
+std::vector<test_case>& registry()
+{
+  static std::vector<test_case> tests;
+  return tests;
+}
+
+std::size_t allocation_count() noexcept
+{
+  return local::allocations.load(std::memory_order_relaxed);
+}
+
+void check_failed(char const* expr, char const* file, int line)
+{
+  throw local::check_failure{std::string{file} + ":" + std::to_string(line) + ": " + expr};
+}
+
+int run(char const* filter)
+{
+  int failures = 0;
+  for (auto& test : registry()) {
+    if (filter && !std::strstr(test.name, filter))
+      continue;
+    std::printf("%s ... ", test.name);
+    std::fflush(stdout);
+    try {
+      test.fn();
+      std::printf("ok\n");
+    } catch (std::exception const& e) {
+      std::printf("FAILED\n  %s\n", e.what());
+      ++failures;
+    } catch (...) {
+      std::printf("FAILED\n  unknown exception\n");
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+}  // namespace iol_test
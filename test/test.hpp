@@ -0,0 +1,42 @@
+#ifndef IOL_TEST_TEST_HPP
+#define IOL_TEST_TEST_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace iol_test
+{
+
+struct test_case {
+  char const* name;
+  void (*fn)();
+};
+
+std::vector<test_case>& registry();
+
+struct registrar {
+  registrar(char const* name, void (*fn)()) { registry().push_back({name, fn}); }
+};
+
+// global operator new calls so far, on any thread
+std::size_t allocation_count() noexcept;
+
+[[noreturn]] void check_failed(char const* expr, char const* file, int line);
+
+/*
+ * Runs every registered test whose name contains filter, all of them if filter is null.
+ * Returns the number of failures.
+ * */
+int run(char const* filter);
+
+}  // namespace iol_test
+
+#define IOL_TEST(NAME)                                              \
+  static void NAME();                                               \
+  static ::iol_test::registrar const NAME##_registrar{#NAME, NAME}; \
+  static void NAME()
+
+#define IOL_CHECK(EXPR) \
+  ((EXPR) ? void(0) : ::iol_test::check_failed(#EXPR, __FILE__, __LINE__))
+
+#endif  // IOL_TEST_TEST_HPP
@@ -0,0 +1,63 @@
+#include "test.hpp"
+
+#include <iol/static_thread_pool.hpp>
+#include <iol/thread_caching_allocator.hpp>
+
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+IOL_TEST(thread_caching_allocator_reuses_blocks_freed_on_other_threads)
+{
+  constexpr std::size_t count = 10000;
+
+  iol::thread_caching_allocator<std::array<char, 48>> allocator;
+
+  std::vector<std::array<char, 48>*> blocks(count);
+  for (auto& block : blocks)
+    block = allocator.allocate(1);
+  std::thread{[&]
+              {
+                for (auto* block : blocks)
+                  allocator.deallocate(block, 1);
+              }}
+      .join();
+
+  // the blocks come back to this thread once its own free list runs dry
+  auto const before = iol_test::allocation_count();
+  for (auto& block : blocks)
+    block = allocator.allocate(1);
+  IOL_CHECK(iol_test::allocation_count() == before);
+
+  for (auto* block : blocks)
+    allocator.deallocate(block, 1);
+}
+
+IOL_TEST(static_thread_pool_posts_without_allocating_once_warm)
+{
+  constexpr std::size_t count = 20000;
+  constexpr std::size_t wave = 100;
+
+  iol::static_thread_pool pool{2};
+  std::atomic_size_t      ran{0};
+
+  // waves bound how many operations are in flight, the warm up pass sees the same depth
+  auto const post_all = [&]
+  {
+    ran.store(0);
+    for (std::size_t i = 0; i < count; ++i) {
+      pool.post([&, pad = std::array<char, 24>{}] { ran.fetch_add(1 + pad[0]); });
+      if (i % wave == wave - 1)
+        while (ran.load() != i + 1)
+          std::this_thread::yield();
+    }
+  };
+
+  post_all();
+  auto const before = iol_test::allocation_count();
+  post_all();
+  IOL_CHECK(iol_test::allocation_count() == before);
+
+  pool.wait();
+}
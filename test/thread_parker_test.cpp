@@ -0,0 +1,59 @@
+#include "test.hpp"
+
+#include <iol/detail/thread_parker.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+IOL_TEST(thread_parker_remembers_an_unpark_before_park)
+{
+  iol::detail::thread_parker parker;
+
+  // returns right away, the unpark came first
+  parker.unpark();
+  parker.park();
+
+  // wake ups don't add up, the second park has to wait for a new unpark
+  parker.unpark();
+  parker.unpark();
+  parker.park();
+
+  std::atomic_bool unparked{false};
+
+  std::thread waker{[&]
+                    {
+                      std::this_thread::sleep_for(std::chrono::milliseconds{20});
+                      unparked.store(true, std::memory_order_relaxed);
+                      parker.unpark();
+                    }};
+  parker.park();
+  IOL_CHECK(unparked.load(std::memory_order_relaxed));
+  waker.join();
+}
+
+IOL_TEST(thread_parker_ping_pong_loses_no_wake_up)
+{
+  constexpr std::size_t rounds = 100000;
+
+  iol::detail::thread_parker ping;
+  iol::detail::thread_parker pong;
+  std::size_t                returned = 0;
+
+  // either side may unpark the other before it parks
+  std::thread other{[&]
+                    {
+                      for (std::size_t i = 0; i < rounds; ++i) {
+                        ping.park();
+                        pong.unpark();
+                      }
+                    }};
+  for (std::size_t i = 0; i < rounds; ++i) {
+    ping.unpark();
+    pong.park();
+    ++returned;
+  }
+  other.join();
+  IOL_CHECK(returned == rounds);
+}
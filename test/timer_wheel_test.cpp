@@ -0,0 +1,100 @@
+#include "test.hpp"
+
+#include <iol/detail/timer_wheel.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using iol::detail::timer_node;
+using iol::detail::timer_wheel;
+
+std::size_t count(timer_node* list) noexcept
+{
+  std::size_t n = 0;
+  for (; list; list = list->next_timer)
+    ++n;
+  return n;
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(timer_wheel_expires_each_timer_at_its_tick)
+{
+  // both sides of the slot and level boundaries
+  std::vector<local::timer_wheel::tick_type> const expiries = {
+      1, 5, 63, 64, 65, 127, 4095, 4096, 4097, 262143, 262144, 300000, 1 << 30};
+
+  local::timer_wheel             wheel;
+  std::vector<local::timer_node> nodes(expiries.size());
+  for (std::size_t i = 0; i < nodes.size(); ++i)
+    IOL_CHECK(wheel.insert(nodes[i], expiries[i]));
+
+  std::size_t expired = 0;
+  auto        previous = wheel.now();
+  while (!wheel.empty()) {
+    auto const tick = wheel.next_tick();
+    IOL_CHECK(tick > previous);
+    for (auto* node = wheel.advance(tick); node; node = node->next_timer) {
+      // next_tick() never skips a tick a timer expires at
+      IOL_CHECK(node->expiry == tick);
+      ++expired;
+    }
+    previous = tick;
+  }
+  IOL_CHECK(expired == expiries.size());
+  IOL_CHECK(wheel.next_tick() == local::timer_wheel::no_tick);
+}
+
+IOL_TEST(timer_wheel_advances_past_several_timers_at_once)
+{
+  local::timer_wheel             wheel;
+  std::vector<local::timer_node> nodes(3);
+  IOL_CHECK(wheel.insert(nodes[0], 10));
+  IOL_CHECK(wheel.insert(nodes[1], 100));
+  IOL_CHECK(wheel.insert(nodes[2], 10000));
+
+  IOL_CHECK(local::count(wheel.advance(9)) == 0);
+  IOL_CHECK(local::count(wheel.advance(5000)) == 2);
+  IOL_CHECK(wheel.now() == 5000);
+
+  // due already
+  local::timer_node late;
+  IOL_CHECK(!wheel.insert(late, 4000));
+  IOL_CHECK(!late.prev_timer);
+
+  IOL_CHECK(local::count(wheel.advance(10000)) == 1);
+  IOL_CHECK(wheel.empty());
+}
+
+IOL_TEST(timer_wheel_erased_timers_never_expire)
+{
+  local::timer_wheel             wheel;
+  std::vector<local::timer_node> nodes(4);
+  IOL_CHECK(wheel.insert(nodes[0], 70));
+  IOL_CHECK(wheel.insert(nodes[1], 70));
+  IOL_CHECK(wheel.insert(nodes[2], 5000));
+  IOL_CHECK(wheel.insert(nodes[3], 80));
+
+  wheel.erase(nodes[0]);
+  wheel.erase(nodes[2]);
+  IOL_CHECK(!nodes[0].prev_timer);
+
+  auto* node = wheel.advance(100000);
+  IOL_CHECK(local::count(node) == 2);
+  for (; node; node = node->next_timer)
+    IOL_CHECK(node == &nodes[1] || node == &nodes[3]);
+  IOL_CHECK(wheel.empty());
+
+  IOL_CHECK(wheel.insert(nodes[0], 200000));
+  IOL_CHECK(wheel.insert(nodes[2], 100001));
+  IOL_CHECK(local::count(wheel.take_all()) == 2);
+  IOL_CHECK(wheel.empty());
+}
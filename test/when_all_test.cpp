@@ -0,0 +1,173 @@
+#include "test.hpp"
+
+#include <iol/async_manual_reset_event.hpp>
+#include <iol/awaitable.hpp>
+#include <iol/static_thread_pool.hpp>
+#include <iol/sync_wait.hpp>
+#include <iol/when_all.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace
+{
+
+namespace local
+{
+
+using namespace iol;
+
+awaitable<int> number(int i)
+{
+  co_return i;
+}
+
+awaitable<void> nothing()
+{
+  co_return;
+}
+
+awaitable<std::string> text()
+{
+  co_return "text";
+}
+
+awaitable<int> square_on(static_thread_pool& pool, int i)
+{
+  co_await pool.schedule();
+  co_return i * i;
+}
+
+awaitable<int> after(async_manual_reset_event& gate, bool& done)
+{
+  co_await gate;
+  done = true;
+  co_return 1;
+}
+
+awaitable<int> throws(char const* what)
+{
+  throw std::runtime_error{what};
+  co_return 0;
+}
+
+awaitable<void> open(async_manual_reset_event& gate, bool& done)
+{
+  gate.set();
+  done = true;
+  co_return;
+}
+
+awaitable<void> mixed_results()
+{
+  auto [i, v, s] = co_await when_all(number(1), nothing(), text());
+  IOL_CHECK(i == 1);
+  IOL_CHECK(v == std::monostate{});
+  IOL_CHECK(s == "text");
+}
+
+awaitable<std::vector<int>> squares(static_thread_pool& pool, int n)
+{
+  std::vector<awaitable<int>> tasks;
+  for (int i = 0; i < n; ++i)
+    tasks.push_back(square_on(pool, i));
+  co_return co_await when_all(std::move(tasks));
+}
+
+awaitable<void> lets_the_others_finish()
+{
+  async_manual_reset_event gate;
+  bool                     first = false;
+  bool                     last = false;
+  bool                     thrown = false;
+  try {
+    // the first child waits on the last one, after the second threw
+    co_await when_all(after(gate, first), throws("second"), open(gate, last));
+  } catch (std::runtime_error const& e) {
+    thrown = std::string{e.what()} == "second";
+  }
+  IOL_CHECK(thrown);
+  IOL_CHECK(first);
+  IOL_CHECK(last);
+}
+
+awaitable<void> rethrows_the_first_exception()
+{
+  std::vector<awaitable<int>> tasks;
+  tasks.push_back(number(1));
+  tasks.push_back(throws("second"));
+  tasks.push_back(throws("third"));
+  std::string what;
+  try {
+    co_await when_all(std::move(tasks));
+  } catch (std::runtime_error const& e) {
+    what = e.what();
+  }
+  IOL_CHECK(what == "second");
+}
+
+awaitable<void> ready_hands_back_each_outcome()
+{
+  auto [one, thrower] = co_await when_all_ready(number(1), throws("thrown"));
+  IOL_CHECK(co_await std::move(one) == 1);
+  bool thrown = false;
+  try {
+    co_await std::move(thrower);
+  } catch (std::runtime_error const&) {
+    thrown = true;
+  }
+  IOL_CHECK(thrown);
+}
+
+awaitable<void> awaits_moved_awaiters()
+{
+  auto all = when_all(number(1), number(2));
+  auto moved = std::move(all);
+  IOL_CHECK((co_await moved == std::tuple{1, 2}));
+
+  std::vector<awaitable<int>> tasks;
+  tasks.push_back(number(3));
+  auto ready = when_all_ready(std::move(tasks));
+  auto moved_ready = std::move(ready);
+  auto done = co_await moved_ready;
+  IOL_CHECK(done.size() == 1);
+  IOL_CHECK(co_await std::move(done[0]) == 3);
+}
+
+}  // namespace local
+
+}  // namespace
+
+IOL_TEST(when_all_gives_a_tuple_of_mixed_results)
+{
+  iol::sync_wait(local::mixed_results());
+}
+
+IOL_TEST(when_all_gives_a_vector_in_order)
+{
+  iol::static_thread_pool pool{4};
+  auto const              results = iol::sync_wait(local::squares(pool, 1000));
+  IOL_CHECK(results.size() == 1000);
+  for (int i = 0; i < 1000; ++i)
+    IOL_CHECK(results[i] == i * i);
+}
+
+IOL_TEST(when_all_rethrows_once_every_child_finished)
+{
+  iol::sync_wait(local::lets_the_others_finish());
+  iol::sync_wait(local::rethrows_the_first_exception());
+}
+
+IOL_TEST(when_all_ready_hands_back_each_outcome)
+{
+  iol::sync_wait(local::ready_hands_back_each_outcome());
+}
+
+IOL_TEST(when_all_awaiters_move_before_co_await)
+{
+  iol::sync_wait(local::awaits_moved_awaiters());
+}